@@ -0,0 +1,79 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include "matrix_multiplier.h"
+
+// Все планировщики на одних и тех же матрицах, с одним ядром и порядком блоков
+int main(int argc, char* argv[]) {
+    const int N = argc > 1 ? std::atoi(argv[1]) : 80;
+    const int numThreads = std::max(1u, std::thread::hardware_concurrency());
+    MatrixMultiplier multiplier(N);
+    Matrix standard = multiplier.computeStandard();
+    auto schedulers = makeAllSchedulers();
+
+    std::cout << "\n=== SCHEDULER COMPARISON ===\n";
+    std::cout << "Matrix " << N << "x" << N << ", " << numThreads << " worker threads\n\n";
+    std::cout << std::setw(15) << "Block size"
+              << std::setw(20) << "Number of blocks"
+              << std::setw(20) << "Scheduler"
+              << std::setw(20) << "Time (microsec)"
+              << std::setw(20) << "LLC misses"
+              << std::setw(20) << "Is Valid"
+              << std::endl;
+
+    for (int k : {1, 2, 4, 5, 8, 10, 20, 40, 80}) {
+        int numBlocks = ((N + k - 1) / k) * ((N + k - 1) / k);
+
+        for (auto& scheduler : schedulers) {
+            long long llcMisses = -1;
+            long long parTime = multiplier.multiplyParallel(k, *scheduler, numThreads,
+                                                            TileOrder::Auto, &llcMisses);
+
+            bool isValid = multiplier.verifyMultiplication(standard);
+
+            std::cout << std::setw(15) << k << "x" << k
+                      << std::setw(20) << numBlocks
+                      << std::setw(20) << scheduler->name()
+                      << std::setw(20) << parTime
+                      << std::setw(20) << (llcMisses >= 0 ? std::to_string(llcMisses) : "n/a")
+                      << std::setw(20) << (isValid ? " [OK]" : " [ERROR]")
+                      << std::endl;
+        }
+    }
+
+    std::cout << "\n=== SYMMETRIC PRODUCT A * A^T (upper triangle only) ===\n\n";
+    std::cout << std::setw(15) << "Block size"
+              << std::setw(20) << "Number of blocks"
+              << std::setw(20) << "Scheduler"
+              << std::setw(20) << "Time (microsec)"
+              << std::setw(20) << "Is Valid"
+              << std::endl;
+
+    Matrix gram = multiplier.computeStandardGram();
+    Matrix gramUpper = multiplier.computeStandardGram(true);
+
+    for (int k : {1, 2, 4, 5, 8, 10, 20, 40, 80}) {
+        int nb = (N + k - 1) / k;
+        int numBlocks = nb * (nb + 1) / 2;
+
+        for (auto& scheduler : schedulers) {
+            long long mirrored = multiplier.multiplySymmetric(k, *scheduler, numThreads, true);
+            bool isValid = multiplier.verifyMultiplication(gram);
+            long long upper = multiplier.multiplySymmetric(k, *scheduler, numThreads, false);
+            isValid = isValid && multiplier.verifyMultiplication(gramUpper);
+
+            std::cout << std::setw(15) << k << "x" << k
+                      << std::setw(20) << numBlocks
+                      << std::setw(20) << scheduler->name()
+                      << std::setw(20) << (std::to_string(mirrored) + " / " + std::to_string(upper))
+                      << std::setw(20) << (isValid ? " [OK]" : " [ERROR]")
+                      << std::endl;
+        }
+    }
+    std::cout << "\nTime: with mirroring / upper triangle only\n";
+
+    return 0;
+}
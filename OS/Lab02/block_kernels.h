@@ -0,0 +1,176 @@
+#ifndef BLOCK_KERNELS_H
+#define BLOCK_KERNELS_H
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+using Matrix = std::vector<std::vector<int>>;
+
+// Ядро считает один блок C: out[(i - rowStart) * (colEnd - colStart) + (j - colStart)]
+// Сумма берется по всему k, запись в C делает вызывающий код.
+using TileKernel = void (*)(const Matrix& A, const Matrix& B, int N,
+                            int rowStart, int rowEnd, int colStart, int colEnd, int* out);
+
+// Общее ядро с границами времени выполнения (и для неполных блоков на краю)
+inline void multiplyTileGeneric(const Matrix& A, const Matrix& B, int N,
+                                int rowStart, int rowEnd, int colStart, int colEnd, int* out) {
+    int width = colEnd - colStart;
+    std::fill(out, out + (rowEnd - rowStart) * width, 0);
+
+    for (int i = rowStart; i < rowEnd; i++) {
+        int* row = out + (i - rowStart) * width;
+        for (int k = 0; k < N; k++) {
+            int a = A[i][k];
+            const int* b = B[k].data() + colStart;
+            for (int j = 0; j < width; j++) {
+                row[j] += a * b[j];
+            }
+        }
+    }
+}
+
+// Ядро для полного блока BS x BS: границы циклов - константы компиляции,
+// поэтому внутренний цикл по j разворачивается и векторизуется,
+// а аккумулятор живет на стеке/в регистрах
+template<int BS>
+void multiplyTileFixed(const Matrix& A, const Matrix& B, int N,
+                       int rowStart, int, int colStart, int, int* out) {
+    int acc[BS][BS] = {};
+
+    for (int k = 0; k < N; k++) {
+        const int* b = B[k].data() + colStart;
+        for (int i = 0; i < BS; i++) {
+            int a = A[rowStart + i][k];
+            for (int j = 0; j < BS; j++) {
+                acc[i][j] += a * b[j];
+            }
+        }
+    }
+
+    for (int i = 0; i < BS; i++) {
+        for (int j = 0; j < BS; j++) {
+            out[i * BS + j] = acc[i][j];
+        }
+    }
+}
+
+// Размеры блоков из перебора в main
+inline constexpr std::array<std::pair<int, TileKernel>, 9> tileKernels = {{
+    {1,  &multiplyTileFixed<1>},
+    {2,  &multiplyTileFixed<2>},
+    {4,  &multiplyTileFixed<4>},
+    {5,  &multiplyTileFixed<5>},
+    {8,  &multiplyTileFixed<8>},
+    {10, &multiplyTileFixed<10>},
+    {20, &multiplyTileFixed<20>},
+    {40, &multiplyTileFixed<40>},
+    {80, &multiplyTileFixed<80>},
+}};
+
+// Специализированное ядро для blockSize или общее, если такого нет
+constexpr TileKernel selectTileKernel(int blockSize) {
+    for (const auto& [size, kernel] : tileKernels) {
+        if (size == blockSize) return kernel;
+    }
+    return &multiplyTileGeneric;
+}
+
+// Блок матрицы Грама C = A * A^T: C[i][j] = sum_k A[i][k] * A[j][k].
+// A^T не строится - строки i и j читаются подряд. Для диагонального блока
+// (upperOnly) считается только j >= i, остальное заполняет зеркалирование.
+inline void multiplyTileGram(const Matrix& A, int N,
+                             int rowStart, int rowEnd, int colStart, int colEnd,
+                             bool upperOnly, int* out) {
+    int width = colEnd - colStart;
+    for (int i = rowStart; i < rowEnd; i++) {
+        const int* a = A[i].data();
+        int jFirst = upperOnly ? std::max(i, colStart) : colStart;
+        for (int j = jFirst; j < colEnd; j++) {
+            const int* b = A[j].data();
+            int sum = 0;
+            for (int k = 0; k < N; k++) {
+                sum += a[k] * b[k];
+            }
+            out[(i - rowStart) * width + (j - colStart)] = sum;
+        }
+    }
+}
+
+// Маленькие матрицы фиксированного размера: все три цикла раскрываются
+// на этапе компиляции через index_sequence, функция пригодна для constexpr
+template<int N>
+using SmallMatrix = std::array<std::array<int, N>, N>;
+
+namespace detail {
+
+template<int N, std::size_t... K>
+constexpr int dotSmall(const SmallMatrix<N>& a, const SmallMatrix<N>& b,
+                       std::size_t i, std::size_t j, std::index_sequence<K...>) {
+    return ((a[i][K] * b[K][j]) + ...);
+}
+
+template<int N, std::size_t... J>
+constexpr std::array<int, N> rowSmall(const SmallMatrix<N>& a, const SmallMatrix<N>& b,
+                                      std::size_t i, std::index_sequence<J...>) {
+    return {dotSmall<N>(a, b, i, J, std::make_index_sequence<N>{})...};
+}
+
+template<int N, std::size_t... I>
+constexpr SmallMatrix<N> multiplySmallImpl(const SmallMatrix<N>& a, const SmallMatrix<N>& b,
+                                           std::index_sequence<I...>) {
+    return {rowSmall<N>(a, b, I, std::make_index_sequence<N>{})...};
+}
+
+} // namespace detail
+
+template<int N>
+constexpr SmallMatrix<N> multiplySmall(const SmallMatrix<N>& a, const SmallMatrix<N>& b) {
+    static_assert(N > 0 && N <= 8, "multiplySmall is meant for tiny matrices");
+    return detail::multiplySmallImpl<N>(a, b, std::make_index_sequence<N>{});
+}
+
+static_assert(multiplySmall<2>({{{1, 2}, {3, 4}}}, {{{5, 6}, {7, 8}}})
+              == SmallMatrix<2>{{{19, 22}, {43, 50}}});
+
+// Вся матрица N x N - один блок (blockSize >= N): копируем ее в SmallMatrix
+// и умножаем полностью развернутым multiplySmall
+template<int N>
+void multiplyTileSmall(const Matrix& A, const Matrix& B, int, int, int, int, int, int* out) {
+    SmallMatrix<N> a{};
+    SmallMatrix<N> b{};
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            a[i][j] = A[i][j];
+            b[i][j] = B[i][j];
+        }
+    }
+    SmallMatrix<N> c = multiplySmall<N>(a, b);
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            out[i * N + j] = c[i][j];
+        }
+    }
+}
+
+// Индекс - N - 1
+inline constexpr std::array<TileKernel, 8> smallTileKernels = {
+    &multiplyTileSmall<1>, &multiplyTileSmall<2>, &multiplyTileSmall<3>, &multiplyTileSmall<4>,
+    &multiplyTileSmall<5>, &multiplyTileSmall<6>, &multiplyTileSmall<7>, &multiplyTileSmall<8>,
+};
+
+// Ядро для конкретного блока: крошечная матрица целиком - в развернутое ядро,
+// неполные блоки на краю - в общее
+inline TileKernel tileKernelFor(int N, int blockSize, int rowStart, int rowEnd, int colStart, int colEnd) {
+    if (N <= static_cast<int>(smallTileKernels.size()) && rowStart == 0 && colStart == 0 &&
+        rowEnd == N && colEnd == N) {
+        return smallTileKernels[N - 1];
+    }
+    if (rowEnd - rowStart != blockSize || colEnd - colStart != blockSize) {
+        return &multiplyTileGeneric;
+    }
+    return selectTileKernel(blockSize);
+}
+
+#endif // BLOCK_KERNELS_H
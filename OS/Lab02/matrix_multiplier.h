@@ -0,0 +1,181 @@
+#ifndef MATRIX_MULTIPLIER_H
+#define MATRIX_MULTIPLIER_H
+
+#include <vector>
+#include <chrono>
+#include <random>
+#include <mutex>
+#include <algorithm>
+#include "block_kernels.h"
+#include "tile_order.h"
+#include "perf_counter.h"
+#include "schedulers.h"
+
+// Общий умножитель для всех вариантов Lab02: данные, ядро и проверка одни и те же,
+// отличается только планировщик, раздающий блоки C потокам
+class MatrixMultiplier {
+private:
+    Matrix A;
+    Matrix B;
+    Matrix C;
+    int N;
+    std::mutex mtx; // Мьютекс для защиты доступа к C
+
+public:
+    MatrixMultiplier(int size) : N(size) {
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::uniform_int_distribution<> dis(1, 20);
+
+        A.resize(N, std::vector<int>(N));
+        B.resize(N, std::vector<int>(N));
+        C.resize(N, std::vector<int>(N, 0));
+
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                A[i][j] = dis(gen);
+                B[i][j] = dis(gen);
+            }
+        }
+    }
+
+    int size() const { return N; }
+
+    void multiplyBlock(int iBlock, int jBlock, int blockSize) {
+        int rowStart = iBlock * blockSize;
+        int rowEnd   = std::min(rowStart + blockSize, N);
+        int colStart = jBlock * blockSize;
+        int colEnd   = std::min(colStart + blockSize, N);
+        int width    = colEnd - colStart;
+
+        // Полные блоки считаются ядром, специализированным под размер блока
+        std::vector<int> localResult((rowEnd - rowStart) * width);
+        TileKernel kernel = tileKernelFor(N, blockSize, rowStart, rowEnd, colStart, colEnd);
+        kernel(A, B, N, rowStart, rowEnd, colStart, colEnd, localResult.data());
+
+        std::lock_guard<std::mutex> lock(mtx);
+        for (int i = rowStart; i < rowEnd; i++) {
+            for (int j = colStart; j < colEnd; j++) {
+                C[i][j] += localResult[(i - rowStart) * width + (j - colStart)];
+            }
+        }
+    }
+
+    long long multiplyParallel(int blockSize, Scheduler& scheduler, int numThreads,
+                               TileOrder order = TileOrder::RowMajor,
+                               long long* llcMisses = nullptr) {
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < N; j++)
+                C[i][j] = 0;
+
+        int numBlocks = (N + blockSize - 1) / blockSize;
+        long long l3Bytes = l3CacheBytes();
+        if (order == TileOrder::Auto) {
+            order = chooseTileOrder(N, blockSize, l3Bytes);
+        }
+        // Порядок считаем до замера времени: он не зависит от данных
+        std::vector<std::pair<int, int>> tiles =
+            makeTileOrder(order, numBlocks, superTileBlocks(N, blockSize, l3Bytes));
+
+        // Счетчик создается до воркеров, чтобы они его унаследовали
+        LlcMissCounter counter;
+        counter.start();
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        scheduler.run(static_cast<int>(tiles.size()), numThreads, [&](int task) {
+            multiplyBlock(tiles[task].first, tiles[task].second, blockSize);
+        });
+
+        auto end = std::chrono::high_resolution_clock::now();
+        counter.stop();
+        if (llcMisses) {
+            *llcMisses = counter.value();
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    }
+
+    // C = A * A^T (SYRK): считаются только блоки верхнего треугольника,
+    // каждый блок принадлежит одной задаче, поэтому запись в C идет без блокировки.
+    // mirror - сразу отражать блок в нижний треугольник, иначе он остается нулевым.
+    long long multiplySymmetric(int blockSize, Scheduler& scheduler, int numThreads,
+                                bool mirror = true) {
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < N; j++)
+                C[i][j] = 0;
+
+        int numBlocks = (N + blockSize - 1) / blockSize;
+        std::vector<std::pair<int, int>> tiles = makeUpperTriangleOrder(numBlocks);
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        scheduler.run(static_cast<int>(tiles.size()), numThreads, [&](int task) {
+            multiplyGramBlock(tiles[task].first, tiles[task].second, blockSize, mirror);
+        });
+
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    }
+
+    void multiplyGramBlock(int iBlock, int jBlock, int blockSize, bool mirror) {
+        int rowStart = iBlock * blockSize;
+        int rowEnd   = std::min(rowStart + blockSize, N);
+        int colStart = jBlock * blockSize;
+        int colEnd   = std::min(colStart + blockSize, N);
+        int width    = colEnd - colStart;
+        bool diagonal = iBlock == jBlock;
+
+        std::vector<int> localResult((rowEnd - rowStart) * width, 0);
+        multiplyTileGram(A, N, rowStart, rowEnd, colStart, colEnd, diagonal, localResult.data());
+
+        for (int i = rowStart; i < rowEnd; i++) {
+            for (int j = diagonal ? i : colStart; j < colEnd; j++) {
+                int value = localResult[(i - rowStart) * width + (j - colStart)];
+                C[i][j] = value;
+                if (mirror) C[j][i] = value;
+            }
+        }
+    }
+
+    // Эталон A * A^T; при upperOnly нижний треугольник нулевой
+    Matrix computeStandardGram(bool upperOnly = false) const {
+        Matrix standard(N, std::vector<int>(N, 0));
+        for (int i = 0; i < N; i++) {
+            for (int j = upperOnly ? i : 0; j < N; j++) {
+                int sum = 0;
+                for (int k = 0; k < N; k++) {
+                    sum += A[i][k] * A[j][k];
+                }
+                standard[i][j] = sum;
+            }
+        }
+        return standard;
+    }
+
+    bool verifyMultiplication(const Matrix& check) const {
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                if (C[i][j] != check[i][j]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    Matrix computeStandard() const {
+        Matrix standard(N, std::vector<int>(N, 0));
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                int sum = 0;
+                for (int k = 0; k < N; k++) {
+                    sum += A[i][k] * B[k][j];
+                }
+                standard[i][j] = sum;
+            }
+        }
+        return standard;
+    }
+};
+
+#endif // MATRIX_MULTIPLIER_H
@@ -0,0 +1,71 @@
+#ifndef PERF_COUNTER_H
+#define PERF_COUNTER_H
+
+#include <cstring>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+// Счетчик промахов последнего уровня кэша (LLC) через perf_event_open.
+// Создается в потоке-продюсере до запуска воркеров: inherit = 1 добавляет
+// к счетчику события всех потоков, созданных после него (учитываются после join).
+// Если perf недоступен (контейнер, perf_event_paranoid), valid() == false.
+class LlcMissCounter {
+private:
+    int fd = -1;
+
+public:
+    LlcMissCounter() {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_LL
+                    | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd == -1) {
+            // Не все процессоры отдают LL-кэш как HW_CACHE, пробуем общий счетчик
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+    }
+
+    ~LlcMissCounter() {
+        if (fd != -1) close(fd);
+    }
+
+    LlcMissCounter(const LlcMissCounter&) = delete;
+    LlcMissCounter& operator=(const LlcMissCounter&) = delete;
+
+    bool valid() const { return fd != -1; }
+
+    void start() {
+        if (fd == -1) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    void stop() {
+        if (fd == -1) return;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    // -1, если счетчик недоступен
+    long long value() const {
+        if (fd == -1) return -1;
+        uint64_t count = 0;
+        if (read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+        return static_cast<long long>(count);
+    }
+};
+
+#endif // PERF_COUNTER_H
@@ -0,0 +1,262 @@
+#ifndef SCHEDULERS_H
+#define SCHEDULERS_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <numeric>
+#include <algorithm>
+#include <semaphore.h>
+#include <pthread.h>
+#include "../Lab03/buhhered_channel.h"
+
+// Стратегия раздачи задач потокам. Задачи - индексы [0, numTasks),
+// run возвращается, когда выполнены все задачи и потоки завершены.
+class Scheduler {
+public:
+    virtual ~Scheduler() = default;
+    virtual const char* name() const = 0;
+    virtual void run(int numTasks, int numThreads, const std::function<void(int)>& task) = 0;
+};
+
+// Поток на каждый блок (бывший thread-process)
+class ThreadPerTileScheduler : public Scheduler {
+public:
+    const char* name() const override { return "thread-per-tile"; }
+
+    void run(int numTasks, int, const std::function<void(int)>& task) override {
+        std::vector<std::thread> threads;
+        threads.reserve(numTasks);
+        for (int t = 0; t < numTasks; t++) {
+            threads.emplace_back(std::cref(task), t);
+        }
+        for (auto& thread : threads) thread.join();
+    }
+};
+
+// pthread + семафор задач + мьютекс на список задач (бывший semaphore-process)
+class SemaphoreScheduler : public Scheduler {
+private:
+    sem_t task_semaphore;
+    pthread_mutex_t task_mutex = PTHREAD_MUTEX_INITIALIZER;
+    std::vector<int> block_tasks;
+    const std::function<void(int)>* current = nullptr;
+
+    static void* workerThread(void* arg) {
+        SemaphoreScheduler* self = static_cast<SemaphoreScheduler*>(arg);
+
+        while (true) {
+            // Ожидаем доступную задачу
+            sem_wait(&self->task_semaphore);
+
+            int task_index = -1;
+
+            pthread_mutex_lock(&self->task_mutex);
+            if (!self->block_tasks.empty()) {
+                task_index = self->block_tasks.back();
+                self->block_tasks.pop_back();
+            }
+            pthread_mutex_unlock(&self->task_mutex);
+
+            if (task_index == -1) {
+                break;
+            }
+
+            (*self->current)(task_index);
+        }
+        return nullptr;
+    }
+
+public:
+    SemaphoreScheduler() { sem_init(&task_semaphore, 0, 0); }
+
+    ~SemaphoreScheduler() override {
+        sem_destroy(&task_semaphore);
+        pthread_mutex_destroy(&task_mutex);
+    }
+
+    const char* name() const override { return "semaphore"; }
+
+    void run(int numTasks, int numThreads, const std::function<void(int)>& task) override {
+        current = &task;
+
+        // Задачи берутся с конца, поэтому кладем в обратном порядке
+        block_tasks.clear();
+        for (int t = numTasks - 1; t >= 0; t--) {
+            block_tasks.push_back(t);
+        }
+
+        // По одному разрешению на задачу и еще по одному на поток,
+        // чтобы каждый поток увидел пустой список и вышел
+        for (int i = 0; i < numTasks + numThreads; i++) {
+            sem_post(&task_semaphore);
+        }
+
+        std::vector<pthread_t> threads(numThreads);
+        for (int i = 0; i < numThreads; i++) {
+            pthread_create(&threads[i], NULL, &SemaphoreScheduler::workerThread, this);
+        }
+        for (int i = 0; i < numThreads; i++) {
+            pthread_join(threads[i], NULL);
+        }
+
+        // Неиспользованные разрешения не должны перейти в следующий запуск
+        while (sem_trywait(&task_semaphore) == 0) {}
+        current = nullptr;
+    }
+};
+
+// Продюсер шлет задачи воркерам через буферизированный канал (бывший channel-process)
+class ChannelScheduler : public Scheduler {
+private:
+    int capacity;
+
+public:
+    explicit ChannelScheduler(int cap = 100) : capacity(cap) {}
+
+    const char* name() const override { return "channel"; }
+
+    void run(int numTasks, int numThreads, const std::function<void(int)>& task) override {
+        BufferedChannel<int> taskChannel(capacity);
+
+        // Воркер забирает задачи пачками, но не больше своей доли,
+        // чтобы при крупных блоках (мало задач) нагрузка оставалась ровной
+        int batch = std::clamp(numTasks / (numThreads * 8), 1, 64);
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < numThreads; i++) {
+            workers.emplace_back([&]() {
+                std::vector<int> tasks(batch);
+                while (size_t received = taskChannel.RecvMany(tasks)) {
+                    for (size_t t = 0; t < received; t++) task(tasks[t]);
+                }
+            });
+        }
+
+        // Все задачи одной пачкой: мьютекс захватывается по разу на порцию,
+        // поместившуюся в буфер, а не на каждую задачу
+        std::vector<int> all(numTasks);
+        std::iota(all.begin(), all.end(), 0);
+        taskChannel.SendMany(all.begin(), all.end());
+        taskChannel.Close();
+
+        for (auto& worker : workers) worker.join();
+    }
+};
+
+// Статическое разбиение: поток i получает i-й непрерывный отрезок задач.
+// При row-major порядке это полосы строк блоков.
+class StaticRowScheduler : public Scheduler {
+public:
+    const char* name() const override { return "static-rows"; }
+
+    void run(int numTasks, int numThreads, const std::function<void(int)>& task) override {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; i++) {
+            int begin = static_cast<int>(1LL * numTasks * i / numThreads);
+            int end   = static_cast<int>(1LL * numTasks * (i + 1) / numThreads);
+            threads.emplace_back([&task, begin, end]() {
+                for (int t = begin; t < end; t++) task(t);
+            });
+        }
+        for (auto& thread : threads) thread.join();
+    }
+};
+
+// Общий атомарный счетчик: каждый поток берет следующую задачу через fetch_add
+class AtomicDispenserScheduler : public Scheduler {
+public:
+    const char* name() const override { return "atomic-dispenser"; }
+
+    void run(int numTasks, int numThreads, const std::function<void(int)>& task) override {
+        std::atomic<int> next(0);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; i++) {
+            threads.emplace_back([&]() {
+                int t;
+                while ((t = next.fetch_add(1, std::memory_order_relaxed)) < numTasks) {
+                    task(t);
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+    }
+};
+
+// Work-stealing: у каждого потока своя очередь с непрерывным отрезком задач.
+// Владелец берет задачи с начала (сохраняя порядок обхода), вор - с конца чужой очереди.
+class WorkStealingScheduler : public Scheduler {
+private:
+    struct alignas(64) WorkQueue {
+        std::mutex mtx;
+        std::deque<int> tasks;
+    };
+
+    static bool popFront(WorkQueue& queue, int& t) {
+        std::lock_guard<std::mutex> lock(queue.mtx);
+        if (queue.tasks.empty()) return false;
+        t = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+    }
+
+    static bool popBack(WorkQueue& queue, int& t) {
+        std::lock_guard<std::mutex> lock(queue.mtx);
+        if (queue.tasks.empty()) return false;
+        t = queue.tasks.back();
+        queue.tasks.pop_back();
+        return true;
+    }
+
+public:
+    const char* name() const override { return "work-stealing"; }
+
+    void run(int numTasks, int numThreads, const std::function<void(int)>& task) override {
+        std::unique_ptr<WorkQueue[]> queues(new WorkQueue[numThreads]);
+        for (int i = 0; i < numThreads; i++) {
+            int begin = static_cast<int>(1LL * numTasks * i / numThreads);
+            int end   = static_cast<int>(1LL * numTasks * (i + 1) / numThreads);
+            for (int t = begin; t < end; t++) queues[i].tasks.push_back(t);
+        }
+
+        // Задачи не порождают новых, поэтому поток, не нашедший работы
+        // ни у себя, ни у других, может завершаться
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; i++) {
+            threads.emplace_back([&, i]() {
+                int t;
+                while (true) {
+                    if (popFront(queues[i], t)) {
+                        task(t);
+                        continue;
+                    }
+                    bool stolen = false;
+                    for (int v = 1; v < numThreads && !stolen; v++) {
+                        stolen = popBack(queues[(i + v) % numThreads], t);
+                    }
+                    if (!stolen) break;
+                    task(t);
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+    }
+};
+
+// Все планировщики в порядке вывода в бенчмарке
+inline std::vector<std::unique_ptr<Scheduler>> makeAllSchedulers() {
+    std::vector<std::unique_ptr<Scheduler>> all;
+    all.push_back(std::make_unique<ThreadPerTileScheduler>());
+    all.push_back(std::make_unique<SemaphoreScheduler>());
+    all.push_back(std::make_unique<ChannelScheduler>());
+    all.push_back(std::make_unique<StaticRowScheduler>());
+    all.push_back(std::make_unique<WorkStealingScheduler>());
+    all.push_back(std::make_unique<AtomicDispenserScheduler>());
+    return all;
+}
+
+#endif // SCHEDULERS_H
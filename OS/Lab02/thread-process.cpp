@@ -1,125 +1,13 @@
 #include <iostream>
 #include <vector>
-#include <thread>
-#include <chrono>
 #include <iomanip>
-#include <random>
-#include <mutex>
-#include <sstream>
-#include <atomic>
-
-class MatrixMultiplier {
-private:
-    std::vector<std::vector<int>> A;
-    std::vector<std::vector<int>> B;
-    std::vector<std::vector<int>> C;
-    int N;
-    std::atomic<int> block_counter;
-    std::mutex mtx;
-
-public:
-    MatrixMultiplier(int size) : N(size), block_counter(0) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(1, 20);
-
-        A.resize(N, std::vector<int>(N));
-        B.resize(N, std::vector<int>(N));
-        C.resize(N, std::vector<int>(N, 0));
-
-        for (int i = 0; i < N; i++) {
-            for (int j = 0; j < N; j++) {
-                A[i][j] = dis(gen);
-                B[i][j] = dis(gen);
-            }
-        }
-    }
-
-    void multiplyBlock(int iBlock, int jBlock, int blockSize) {
-        int rowStart = iBlock * blockSize;
-        int rowEnd   = std::min(rowStart + blockSize, N);
-        int colStart = jBlock * blockSize;
-        int colEnd   = std::min(colStart + blockSize, N);
-
-        std::vector<std::vector<int>> localResult(rowEnd - rowStart, 
-                                                  std::vector<int>(colEnd - colStart, 0));
-
-        for (int kBlock = 0; kBlock < (N + blockSize - 1) / blockSize; kBlock++) {
-            int kStart = kBlock * blockSize;
-            int kEnd   = std::min(kStart + blockSize, N);
-
-            for (int i = rowStart; i < rowEnd; i++) {
-                for (int j = colStart; j < colEnd; j++) {
-                    int sum = 0;
-                    for (int k = kStart; k < kEnd; k++) {
-                        sum += A[i][k] * B[k][j];
-                    }
-                    localResult[i - rowStart][j - colStart] += sum;
-                }
-            }
-        }
-        
-        std::lock_guard<std::mutex> lock(mtx);
-        for (int i = rowStart; i < rowEnd; i++) {
-            for (int j = colStart; j < colEnd; j++) {
-                C[i][j] += localResult[i - rowStart][j - colStart];
-            }
-        }
-    }
-
-    long long multiplyParallel(int blockSize) {
-        for (int i = 0; i < N; i++)
-            for (int j = 0; j < N; j++)
-                C[i][j] = 0;
-
-        auto start = std::chrono::high_resolution_clock::now();
-
-        std::vector<std::thread> threads;
-        int numBlocks = (N + blockSize - 1) / blockSize;
-
-        for (int iBlock = 0; iBlock < numBlocks; iBlock++) {
-            for (int jBlock = 0; jBlock < numBlocks; jBlock++) {
-                threads.emplace_back(&MatrixMultiplier::multiplyBlock, this,
-                                    iBlock, jBlock, blockSize);
-            }
-        }
-
-        for (auto& t : threads) t.join();
-
-        auto end = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    }
-
-    bool verifyMultiplication(std::vector<std::vector<int>>& check) {
-        for (int i = 0; i < N; i++) {
-            for (int j = 0; j < N; j++) {
-                if (C[i][j] != check[i][j]) {
-                    return false;
-                }
-            }
-        }
-        return true;
-    }
-
-    std::vector<std::vector<int>> computeStandard() {
-        std::vector<std::vector<int>> standard(N, std::vector<int>(N, 0));
-        for (int i = 0; i < N; i++) {
-            for (int j = 0; j < N; j++) {
-                int sum = 0;
-                for (int k = 0; k < N; k++) {
-                    sum += A[i][k] * B[k][j];
-                }
-                standard[i][j] = sum;
-            }
-        }
-        return standard;
-    }
-};
+#include "matrix_multiplier.h"
 
 int main() {
     const int N = 80;
     MatrixMultiplier multiplier(N);
-    std::vector<std::vector<int>> standard = multiplier.computeStandard();
+    ThreadPerTileScheduler scheduler;
+    Matrix standard = multiplier.computeStandard();
 
     std::cout << "\n=== PERFORMANCE COMPARISON ===\n";
     std::cout << "\n2. Parallel algorithm with different block sizes:\n";
@@ -132,7 +20,7 @@ int main() {
               
     for (int k : {1, 2, 4, 5, 8, 10, 20, 40, 80}) {
         int numBlocks = ((N + k - 1) / k) * ((N + k - 1) / k);
-        long long parTime = multiplier.multiplyParallel(k);
+        long long parTime = multiplier.multiplyParallel(k, scheduler, numBlocks);
         
         bool isValid = multiplier.verifyMultiplication(standard);
         
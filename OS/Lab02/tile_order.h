@@ -0,0 +1,151 @@
+#ifndef TILE_ORDER_H
+#define TILE_ORDER_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+// Порядок, в котором продюсер выдает блоки C воркерам
+enum class TileOrder {
+    Auto,
+    RowMajor,
+    ColumnMajor,
+    Hilbert,
+    SuperTile
+};
+
+inline const char* tileOrderName(TileOrder order) {
+    switch (order) {
+        case TileOrder::Auto:        return "auto";
+        case TileOrder::RowMajor:    return "row-major";
+        case TileOrder::ColumnMajor: return "column-major";
+        case TileOrder::Hilbert:     return "hilbert";
+        case TileOrder::SuperTile:   return "super-tile";
+    }
+    return "unknown";
+}
+
+// Размер L3 в байтах; если узнать не удалось - 8 МБ
+inline long long l3CacheBytes() {
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    long size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (size > 0) return size;
+#endif
+    std::ifstream file("/sys/devices/system/cpu/cpu0/cache/index3/size");
+    std::string value;
+    if (file >> value && !value.empty()) {
+        long long size = std::stoll(value);
+        char unit = value.back();
+        if (unit == 'K') size *= 1024;
+        if (unit == 'M') size *= 1024 * 1024;
+        if (size > 0) return size;
+    }
+    return 8LL * 1024 * 1024;
+}
+
+// Сторона супер-блока (в блоках): полоса A и полоса B должны вместе занимать
+// не больше половины L3, вторая половина остается под C и чужие данные
+inline int superTileBlocks(int N, int blockSize, long long l3Bytes) {
+    long long panelBytes = 1LL * blockSize * N * sizeof(int);
+    long long fit = (l3Bytes / 2) / (2 * panelBytes);
+    return static_cast<int>(std::max(1LL, fit));
+}
+
+// Выбор порядка по размеру матрицы и кэша:
+//  - A, B и C целиком помещаются в L3 - порядок не важен, берем row-major;
+//  - сетка блоков - степень двойки - кривая Гильберта без "дыр";
+//  - иначе супер-блоки под размер L3.
+inline TileOrder chooseTileOrder(int N, int blockSize, long long l3Bytes) {
+    long long workingSet = 3LL * N * N * sizeof(int);
+    if (workingSet <= l3Bytes) {
+        return TileOrder::RowMajor;
+    }
+    int numBlocks = (N + blockSize - 1) / blockSize;
+    if ((numBlocks & (numBlocks - 1)) == 0) {
+        return TileOrder::Hilbert;
+    }
+    return TileOrder::SuperTile;
+}
+
+// Преобразование индекса d на кривой Гильберта в координаты (x, y) сетки n x n
+inline std::pair<int, int> hilbertPoint(int n, long long d) {
+    int x = 0, y = 0;
+    for (int s = 1; s < n; s *= 2) {
+        int rx = 1 & static_cast<int>(d / 2);
+        int ry = 1 & static_cast<int>(d ^ rx);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+        x += s * rx;
+        y += s * ry;
+        d /= 4;
+    }
+    return {x, y};
+}
+
+// Список (iBlock, jBlock) в заданном порядке обхода
+inline std::vector<std::pair<int, int>> makeTileOrder(TileOrder order, int numBlocks,
+                                                      int superBlocks = 1) {
+    std::vector<std::pair<int, int>> tiles;
+    tiles.reserve(static_cast<size_t>(numBlocks) * numBlocks);
+
+    switch (order) {
+        case TileOrder::Auto:
+        case TileOrder::RowMajor:
+            for (int i = 0; i < numBlocks; i++)
+                for (int j = 0; j < numBlocks; j++)
+                    tiles.emplace_back(i, j);
+            break;
+
+        case TileOrder::ColumnMajor:
+            for (int j = 0; j < numBlocks; j++)
+                for (int i = 0; i < numBlocks; i++)
+                    tiles.emplace_back(i, j);
+            break;
+
+        case TileOrder::Hilbert: {
+            int n = 1;
+            while (n < numBlocks) n *= 2;
+            for (long long d = 0; d < 1LL * n * n; d++) {
+                auto [i, j] = hilbertPoint(n, d);
+                if (i < numBlocks && j < numBlocks) {
+                    tiles.emplace_back(i, j);
+                }
+            }
+            break;
+        }
+
+        case TileOrder::SuperTile: {
+            int s = std::max(1, superBlocks);
+            for (int si = 0; si < numBlocks; si += s)
+                for (int sj = 0; sj < numBlocks; sj += s)
+                    for (int i = si; i < std::min(si + s, numBlocks); i++)
+                        for (int j = sj; j < std::min(sj + s, numBlocks); j++)
+                            tiles.emplace_back(i, j);
+            break;
+        }
+    }
+    return tiles;
+}
+
+// Блоки верхнего треугольника (iBlock <= jBlock) одним плоским списком.
+// Задачи в нем почти равной стоимости (кроме диагональных), поэтому и
+// статическое разбиение на отрезки, и динамическая раздача дают ровную нагрузку,
+// в отличие от цикла по строкам блоков, где строка i содержит numBlocks - i блоков.
+inline std::vector<std::pair<int, int>> makeUpperTriangleOrder(int numBlocks) {
+    std::vector<std::pair<int, int>> tiles;
+    tiles.reserve(static_cast<size_t>(numBlocks) * (numBlocks + 1) / 2);
+    for (int i = 0; i < numBlocks; i++)
+        for (int j = i; j < numBlocks; j++)
+            tiles.emplace_back(i, j);
+    return tiles;
+}
+
+#endif // TILE_ORDER_H
@@ -0,0 +1,36 @@
+#ifndef ALLOC_COUNTER_H_
+#define ALLOC_COUNTER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Счетчик выделений памяти во всей программе: замена глобальных operator new
+// и delete. Замены не бывают inline, поэтому заголовок подключается ровно
+// в одну единицу трансляции программы - в ту, где main.
+// noinline - чтобы GCC не сопоставлял встроенный malloc с free
+// и не выдавал ложных предупреждений
+inline std::atomic<long long> g_allocations{0};
+
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+// Выровненные версии тоже: через них выделяются слоты RingBuffer, каналы
+// и другие alignas-типы, иначе они прошли бы мимо счетчика
+[[gnu::noinline]] void* operator new(std::size_t size, std::align_val_t align) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    auto alignment = static_cast<std::size_t>(align);
+    if (void* ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) return ptr;
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* ptr) noexcept { std::free(ptr); }
+[[gnu::noinline]] void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+[[gnu::noinline]] void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+[[gnu::noinline]] void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+#endif // ALLOC_COUNTER_H_
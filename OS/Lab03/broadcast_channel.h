@@ -0,0 +1,239 @@
+#ifndef BROADCAST_CHANNEL_H_
+#define BROADCAST_CHANNEL_H_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "channel_status.h"
+#include "ring_buffer.h"
+
+// Что делать отправителю, когда самый медленный подписчик отстал на capacity
+enum class OverflowPolicy {
+    kBlock,       // ждать его (обратное давление)
+    kDropOldest,  // затереть самое старое сообщение, отставшим засчитать потерю
+};
+
+// Канал "один ко многим": каждое сообщение получает каждый подписчик.
+// Сообщения лежат в одном общем кольце, у подписчика - только свой курсор,
+// так что отправка стоит одно копирование независимо от числа подписчиков.
+// Слот освобождается, когда его прочитали все.
+// Подписчик видит сообщения, отправленные после Subscribe(); без подписчиков
+// сообщения сразу отбрасываются.
+template<class T>
+class BroadcastChannel {
+    struct Cursor {
+        uint64_t next;
+        uint64_t dropped = 0;
+    };
+
+public:
+    // Подписка; отписка - в деструкторе. Recv возвращает копию сообщения
+    class Subscription {
+    public:
+        Subscription(Subscription&& other) noexcept
+            : channel_(std::exchange(other.channel_, nullptr)),
+              cursor_(std::exchange(other.cursor_, nullptr)) {}
+
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+        Subscription& operator=(Subscription&&) = delete;
+
+        ~Subscription() {
+            if (channel_) channel_->Unsubscribe(cursor_);
+        }
+
+        std::pair<T, bool> Recv() { return channel_->Recv(cursor_); }
+        ChannelStatus TryRecv(T& out) { return channel_->TryRecv(cursor_, out); }
+
+        // Сколько сообщений затерто до прочтения (только kDropOldest)
+        uint64_t Dropped() { return channel_->Dropped(cursor_); }
+
+    private:
+        friend class BroadcastChannel;
+
+        Subscription(BroadcastChannel* channel, Cursor* cursor)
+            : channel_(channel), cursor_(cursor) {}
+
+        BroadcastChannel* channel_;
+        Cursor* cursor_;
+    };
+
+    explicit BroadcastChannel(int size, OverflowPolicy policy = OverflowPolicy::kBlock)
+        : capacity_(CheckedCapacity(size, "BroadcastChannel")),
+          mask_(RoundUpPow2(capacity_) - 1),
+          slots_(new Slot[mask_ + 1]),
+          policy_(policy) {}
+
+    ~BroadcastChannel() {
+        for (uint64_t seq = head_; seq != tail_; ++seq) {
+            Item(seq)->~T();
+        }
+    }
+
+    BroadcastChannel(const BroadcastChannel&) = delete;
+    BroadcastChannel& operator=(const BroadcastChannel&) = delete;
+
+    Subscription Subscribe() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        cursors_.push_back(std::make_unique<Cursor>(Cursor{tail_}));
+        return Subscription(this, cursors_.back().get());
+    }
+
+    void Send(T value) {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        if (policy_ == OverflowPolicy::kBlock) {
+            ++send_waiters_;
+            send_cv_.wait(lock, [this]() {
+                return tail_ - head_ < capacity_ || closed_;
+            });
+            --send_waiters_;
+        }
+        if (closed_) {
+            throw std::runtime_error("Channel is closed");
+        }
+        if (tail_ - head_ >= capacity_) {
+            DropOldestLocked();
+        }
+
+        new (slots_[tail_ & mask_].data) T(std::move(value));
+        ++tail_;
+        if (cursors_.empty()) {
+            ReleaseLocked(tail_);
+        }
+        if (recv_waiters_ > 0) {
+            recv_cv_.notify_all();
+        }
+    }
+
+    void Close() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        closed_ = true;
+        send_cv_.notify_all();
+        recv_cv_.notify_all();
+    }
+
+    std::size_t Subscribers() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        return cursors_.size();
+    }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    T* Item(uint64_t seq) {
+        return std::launder(reinterpret_cast<T*>(slots_[seq & mask_].data));
+    }
+
+    std::pair<T, bool> Recv(Cursor* cursor) {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        ++recv_waiters_;
+        recv_cv_.wait(lock, [this, cursor]() {
+            return cursor->next != tail_ || closed_;
+        });
+        --recv_waiters_;
+
+        if (cursor->next == tail_) {
+            return {T(), false};
+        }
+        return {ReadLocked(cursor), true};
+    }
+
+    ChannelStatus TryRecv(Cursor* cursor, T& out) {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        if (cursor->next == tail_) {
+            return closed_ ? ChannelStatus::kClosed : ChannelStatus::kEmpty;
+        }
+        out = ReadLocked(cursor);
+        return ChannelStatus::kOk;
+    }
+
+    uint64_t Dropped(Cursor* cursor) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        return cursor->dropped;
+    }
+
+    void Unsubscribe(Cursor* cursor) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        bool was_slowest = cursor->next == head_;
+        auto it = std::find_if(cursors_.begin(), cursors_.end(),
+                               [cursor](const auto& c) { return c.get() == cursor; });
+        cursors_.erase(it);
+        if (was_slowest) {
+            ReleaseLocked(MinCursorLocked());
+        }
+    }
+
+    // Копия сообщения; если этот подписчик был самым медленным,
+    // освобождаем слоты, которые больше никому не нужны
+    T ReadLocked(Cursor* cursor) {
+        T value = *Item(cursor->next);
+        bool was_slowest = cursor->next == head_;
+        ++cursor->next;
+        if (was_slowest) {
+            ReleaseLocked(MinCursorLocked());
+        }
+        return value;
+    }
+
+    uint64_t MinCursorLocked() const {
+        uint64_t min = tail_;
+        for (const auto& cursor : cursors_) {
+            min = std::min(min, cursor->next);
+        }
+        return min;
+    }
+
+    void ReleaseLocked(uint64_t new_head) {
+        if (new_head == head_) {
+            return;
+        }
+        for (; head_ != new_head; ++head_) {
+            Item(head_)->~T();
+        }
+        if (send_waiters_ > 0) {
+            send_cv_.notify_all();
+        }
+    }
+
+    // Кольцо полно: самое старое сообщение уходит, отставшие перескакивают его
+    void DropOldestLocked() {
+        for (auto& cursor : cursors_) {
+            if (cursor->next == head_) {
+                ++cursor->next;
+                ++cursor->dropped;
+            }
+        }
+        Item(head_)->~T();
+        ++head_;
+    }
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    const OverflowPolicy policy_;
+
+    std::mutex mtx_;
+    std::condition_variable send_cv_;
+    std::condition_variable recv_cv_;
+    uint64_t head_ = 0;  // самое старое непрочитанное кем-то сообщение
+    uint64_t tail_ = 0;
+    bool closed_ = false;
+    int send_waiters_ = 0;
+    int recv_waiters_ = 0;
+    std::vector<std::unique_ptr<Cursor>> cursors_;
+};
+
+#endif // BROADCAST_CHANNEL_H_
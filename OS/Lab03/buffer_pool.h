@@ -0,0 +1,111 @@
+#ifndef BUFFER_POOL_H_
+#define BUFFER_POOL_H_
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "buhhered_channel.h"
+#include "channel_status.h"
+
+// Пул заранее выделенных буферов для каналов с крупными сообщениями.
+// Отправитель берет буфер (Acquire), заполняет и отправляет Lease по каналу;
+// получатель обрабатывает, и буфер возвращается в пул при разрушении Lease.
+// Свободные буферы лежат в BufferedChannel, так что пустой пул естественно
+// тормозит отправителей, а в установившемся режиме нет ни одного new/delete.
+// Пул должен пережить все выданные Lease.
+template<class Buffer>
+class BufferPool {
+public:
+    class Lease {
+    public:
+        Lease() = default;
+
+        Lease(Lease&& other) noexcept
+            : pool_(std::exchange(other.pool_, nullptr)),
+              buffer_(std::move(other.buffer_)) {}
+
+        Lease& operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                Release();
+                pool_ = std::exchange(other.pool_, nullptr);
+                buffer_ = std::move(other.buffer_);
+            }
+            return *this;
+        }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        ~Lease() { Release(); }
+
+        Buffer& operator*() const { return *buffer_; }
+        Buffer* operator->() const { return buffer_.get(); }
+        explicit operator bool() const { return buffer_ != nullptr; }
+
+        // Вернуть буфер в пул раньше разрушения
+        void Release() {
+            if (pool_ && buffer_) {
+                pool_->Return(std::move(buffer_));
+            }
+            pool_ = nullptr;
+            buffer_.reset();
+        }
+
+    private:
+        friend class BufferPool;
+
+        Lease(BufferPool* pool, std::unique_ptr<Buffer> buffer)
+            : pool_(pool), buffer_(std::move(buffer)) {}
+
+        BufferPool* pool_ = nullptr;
+        std::unique_ptr<Buffer> buffer_;
+    };
+
+    // count буферов, каждый создается make() один раз. Пул без буферов
+    // вечно ждал бы в Acquire, поэтому count <= 0 - std::invalid_argument
+    template<class Factory>
+    BufferPool(int count, Factory make) : free_(CheckedCount(count)) {
+        for (int i = 0; i < count; ++i) {
+            free_.Send(std::unique_ptr<Buffer>(new Buffer(make())));
+        }
+    }
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // Ждет свободный буфер
+    Lease Acquire() {
+        std::unique_ptr<Buffer> buffer;
+        free_.RecvInto(buffer);
+        return Lease(this, std::move(buffer));
+    }
+
+    // kEmpty - все буферы на руках
+    ChannelStatus TryAcquire(Lease& lease) {
+        std::unique_ptr<Buffer> buffer;
+        ChannelStatus status = free_.TryRecv(buffer);
+        if (status == ChannelStatus::kOk) {
+            lease = Lease(this, std::move(buffer));
+        }
+        return status;
+    }
+
+private:
+    static int CheckedCount(int count) {
+        if (count <= 0) {
+            throw std::invalid_argument("BufferPool needs at least one buffer");
+        }
+        return count;
+    }
+
+    // Емкость канала равна числу буферов, поэтому возврат не блокируется
+    void Return(std::unique_ptr<Buffer> buffer) {
+        free_.TrySend(std::move(buffer));
+    }
+
+    BufferedChannel<std::unique_ptr<Buffer>> free_;
+};
+
+#endif // BUFFER_POOL_H_
@@ -1,76 +1,584 @@
 #ifndef BUFFERED_CHANNEL_H_
 #define BUFFERED_CHANNEL_H_
 
-#include <queue>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <memory>
 #include <mutex>
-#include <condition_variable>
+#include <optional>
+#include <span>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
-template<class T>
+#include "channel_awaiters.h"
+#include "channel_eventfd.h"
+#include "channel_stats.h"
+#include "channel_status.h"
+#include "channel_waiter.h"
+#include "ring_buffer.h"
+#include "select_watcher.h"
+
+// Waiter - стратегия ожидания (channel_waiter.h): CondVarWaiter или
+// SpinFutexWaiter для передачи с задержкой меньше микросекунды
+template<class T, class Waiter = CondVarWaiter>
 class BufferedChannel {
 public:
-    explicit BufferedChannel(int size) 
-        : capacity_(size > 0 ? size : 0), 
-          closed_(false) {}
+    using WaitOptions = typename Waiter::Options;
+
+    // Емкость 0 (синхронная передача) - это RendezvousChannel: здесь Send
+    // ждал бы места в буфере вечно, поэтому такой размер сразу отвергаем
+    explicit BufferedChannel(int size, const WaitOptions& options = {})
+        : capacity_(CheckedCapacity(size)),
+          buffer_(capacity_),
+          closed_(false),
+          send_waiter_(options),
+          recv_waiter_(options),
+          stats_(capacity_) {}
 
     void Send(T value) {
+        if (SendNoThrow(std::move(value)) == ChannelStatus::kClosed) {
+            throw std::runtime_error("Channel is closed");
+        }
+    }
+
+    std::pair<T, bool> Recv() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        WaitForItem(lock);
+
+        if (buffer_.Empty()) {
+            return {T(), false};
+        }
+        return {PopLocked(), true};
+    }
+
+    // Блокирующая отправка без исключений: kOk или kClosed
+    ChannelStatus SendNoThrow(T value) {
         std::unique_lock<std::mutex> lock(mtx_);
-        
+        WaitForSpace(lock);
+
         if (closed_) {
-            throw std::runtime_error("Channel is closed");
+            return ChannelStatus::kClosed;
         }
-        
-        send_cv_.wait(lock, [this]() { 
-            return buffer_.size() < capacity_ || closed_; 
-        });
-        
+        PushLocked(std::move(value));
+        return ChannelStatus::kOk;
+    }
+
+    // Конструирует элемент прямо в слоте канала, без промежуточных перемещений
+    template<class... Args>
+    void Emplace(Args&&... args) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        WaitForSpace(lock);
+
         if (closed_) {
             throw std::runtime_error("Channel is closed");
         }
-        
-        buffer_.push(std::move(value));
-        
-        recv_cv_.notify_one();
+        PushLocked(std::forward<Args>(args)...);
     }
 
-    std::pair<T, bool> Recv() {
+    // Перемещает элемент в out одним присваиванием; false - канал закрыт и пуст.
+    // В отличие от Recv() не требует конструктора T по умолчанию
+    bool RecvInto(T& out) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        WaitForItem(lock);
+
+        if (buffer_.Empty()) {
+            return false;
+        }
+        PopIntoLocked(out);
+        return true;
+    }
+
+    // Неблокирующие версии: kOk, kFull/kEmpty или kClosed.
+    // value перемещается только при kOk, так что при отказе его можно отбросить или повторить.
+    template<class U>
+    ChannelStatus TrySend(U&& value) {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        if (closed_) {
+            return ChannelStatus::kClosed;
+        }
+        if (buffer_.Size() >= capacity_) {
+            if (readiness_) {
+                readiness_->ClearWritable();
+            }
+            return ChannelStatus::kFull;
+        }
+        PushLocked(std::forward<U>(value));
+        return ChannelStatus::kOk;
+    }
+
+    ChannelStatus TryRecv(T& out) {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        if (buffer_.Empty()) {
+            if (closed_) {
+                return ChannelStatus::kClosed;
+            }
+            if (readiness_) {
+                readiness_->ClearReadable();
+            }
+            return ChannelStatus::kEmpty;
+        }
+        PopIntoLocked(out);
+        return ChannelStatus::kOk;
+    }
+
+    // Ограниченные по времени версии: kOk, kClosed или kTimeout
+    template<class U, class Clock, class Duration>
+    ChannelStatus SendUntil(U&& value, const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        bool ready = WaitForSpaceUntil(lock, deadline);
+
+        if (closed_) {
+            return ChannelStatus::kClosed;
+        }
+        if (!ready) {
+            // Уходим без места: оно могло ждать нас, а не младшие корутины
+            ResumeSendersLocked();
+            return ChannelStatus::kTimeout;
+        }
+        PushLocked(std::forward<U>(value));
+        return ChannelStatus::kOk;
+    }
+
+    template<class U, class Rep, class Period>
+    ChannelStatus SendFor(U&& value, const std::chrono::duration<Rep, Period>& timeout) {
+        return SendUntil(std::forward<U>(value), std::chrono::steady_clock::now() + timeout);
+    }
+
+    template<class Clock, class Duration>
+    ChannelStatus RecvUntil(T& out, const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        bool ready = WaitForItemUntil(lock, deadline);
+
+        if (!buffer_.Empty()) {
+            PopIntoLocked(out);
+            return ChannelStatus::kOk;
+        }
+        if (!ready) {
+            ResumeReceiversLocked();
+            return ChannelStatus::kTimeout;
+        }
+        return ChannelStatus::kClosed;
+    }
+
+    template<class Rep, class Period>
+    ChannelStatus RecvFor(T& out, const std::chrono::duration<Rep, Period>& timeout) {
+        return RecvUntil(out, std::chrono::steady_clock::now() + timeout);
+    }
+
+    // Отправляет [first, last) по порядку. За один захват мьютекса кладет
+    // столько, сколько помещается, и будит получателей одним вызовом на порцию.
+    // Если канал закрылся посередине, уже отправленные элементы остаются в нем.
+    template<class InputIt>
+    void SendMany(InputIt first, InputIt last) {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        while (first != last) {
+            WaitForSpace(lock);
+
+            if (closed_) {
+                throw std::runtime_error("Channel is closed");
+            }
+
+            std::size_t sent = 0;
+            for (; first != last && buffer_.Size() < capacity_; ++first, ++sent) {
+                buffer_.Push(std::move(*first));
+                stats_.OnSend(buffer_.Size());
+            }
+            ResumeReceiversLocked();
+            ResumeSendersLocked();
+            NotifyBatch(recv_waiter_, sent);
+        }
+    }
+
+    // Неблокирующая порция: кладет, сколько помещается, одним захватом мьютекса
+    // и одним пробуждением. Возвращает число отправленных; 0 - полон или закрыт
+    template<class InputIt>
+    std::size_t TrySendMany(InputIt first, InputIt last) {
         std::unique_lock<std::mutex> lock(mtx_);
-        
-        recv_cv_.wait(lock, [this]() { 
-            return !buffer_.empty() || closed_; 
-        });
 
-        if (buffer_.empty() && closed_) {
-            return { T(), false };
+        if (closed_) {
+            return 0;
         }
-        
-        if (!buffer_.empty()) {
-            T value = std::move(buffer_.front());
-            buffer_.pop();
-            
-            send_cv_.notify_one();
-            return {std::move(value), true};
+        std::size_t sent = 0;
+        for (; first != last && buffer_.Size() < capacity_; ++first, ++sent) {
+            buffer_.Push(std::move(*first));
+            stats_.OnSend(buffer_.Size());
         }
-        
-        return {T(), false};
+        ResumeReceiversLocked();
+        ResumeSendersLocked();
+        NotifyBatch(recv_waiter_, sent);
+        return sent;
+    }
+
+    // Ждет хотя бы один элемент и забирает до out.size() элементов.
+    // 0 - канал закрыт и пуст. Пустой out - std::invalid_argument: иначе
+    // 0 нельзя было бы отличить от закрытого канала
+    std::size_t RecvMany(std::span<T> out) {
+        if (out.empty()) {
+            throw std::invalid_argument("RecvMany needs a non-empty buffer");
+        }
+        std::unique_lock<std::mutex> lock(mtx_);
+        WaitForItem(lock);
+
+        std::size_t received = 0;
+        for (; received < out.size() && !buffer_.Empty(); ++received) {
+            out[received] = buffer_.PopFront();
+            stats_.OnRecv(buffer_.Size());
+        }
+        ResumeSendersLocked();
+        ResumeReceiversLocked();
+        NotifyBatch(send_waiter_, received);
+        return received;
+    }
+
+    // Забирает все, что есть сейчас, не блокируясь
+    std::size_t DrainAll(std::vector<T>& out) {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        std::size_t received = buffer_.Size();
+        out.reserve(out.size() + received);
+        while (!buffer_.Empty()) {
+            out.push_back(buffer_.PopFront());
+            stats_.OnRecv(buffer_.Size());
+        }
+        ResumeSendersLocked();
+        ResumeReceiversLocked();
+        NotifyBatch(send_waiter_, received);
+        if (readiness_ && buffer_.Empty() && !closed_) {
+            readiness_->ClearReadable();
+        }
+        return received;
     }
 
     void Close() {
         std::unique_lock<std::mutex> lock(mtx_);
         closed_ = true;
-        
-        send_cv_.notify_all();
-        recv_cv_.notify_all();
+
+        send_waiter_.NotifyAll();
+        recv_waiter_.NotifyAll();
+        NotifyWatchers();
+
+        // Корутинам-получателям сначала достается то, что осталось в буфере;
+        // "закрыт" - только когда он пуст (см. ResumeReceiversLocked)
+        ResumeReceiversLocked();
+        while (!send_awaiters_.Empty()) {
+            SendNode* node = send_awaiters_.PopFront();
+            node->status = ChannelStatus::kClosed;
+            node->Resume();
+        }
     }
 
 private:
-    std::queue<T> buffer_;
-    int capacity_;
+    struct RecvNode : AwaitNode {
+        std::optional<T> value;
+    };
+
+    struct SendNode : AwaitNode {
+        T* value = nullptr;
+        ChannelStatus status = ChannelStatus::kOk;
+    };
+
+public:
+    // co_await channel.AsyncRecv() - то же, что Recv(), но при пустом канале
+    // приостанавливается корутина, а не поток. Вызывать на потоке Executor;
+    // с одним каналом могут одновременно работать и потоки, и корутины.
+    class RecvAwaiter {
+    public:
+        explicit RecvAwaiter(BufferedChannel& channel) : channel_(channel) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            return channel_.SuspendRecv(node_, handle);
+        }
+
+        std::pair<T, bool> await_resume() {
+            if (!node_.value) {
+                return {T(), false};
+            }
+            return {std::move(*node_.value), true};
+        }
+
+    private:
+        BufferedChannel& channel_;
+        RecvNode node_;
+    };
+
+    // co_await channel.AsyncSend(value) - как Send(): бросает, если канал закрыт
+    class SendAwaiter {
+    public:
+        SendAwaiter(BufferedChannel& channel, T value)
+            : channel_(channel), value_(std::move(value)) {
+            node_.value = &value_;
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            return channel_.SuspendSend(node_, handle);
+        }
+
+        void await_resume() {
+            if (node_.status == ChannelStatus::kClosed) {
+                throw std::runtime_error("Channel is closed");
+            }
+        }
+
+    private:
+        BufferedChannel& channel_;
+        T value_;
+        SendNode node_;
+    };
+
+    RecvAwaiter AsyncRecv() { return RecvAwaiter(*this); }
+    SendAwaiter AsyncSend(T value) { return SendAwaiter(*this, std::move(value)); }
+
+    // Снимок счетчиков для периодического вывода; без -DCHANNEL_STATS пустой
+    ChannelStatsSnapshot Stats() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        return stats_.Snapshot(buffer_.Size());
+    }
+
+    // Подписка Select на изменения состояния канала (см. select.h)
+    void Watch(SelectWatcher* watcher) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        watchers_.Add(watcher);
+    }
+
+    void Unwatch(SelectWatcher* watcher) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        watchers_.Remove(watcher);
+    }
+
+    // eventfd для epoll/poll: читаем, когда в канале есть элементы или он
+    // закрыт, пишем, когда есть место. Создаются при первом вызове; пока их
+    // никто не запросил, канал не делает лишних системных вызовов.
+    // По событию разбирать канал через TryRecv/DrainAll или TrySend до
+    // kEmpty/kFull - только тогда fd сбрасывается (см. channel_eventfd.h)
+    int ReadableFd() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        return ReadinessLocked().ReadableFd();
+    }
+
+    int WritableFd() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        return ReadinessLocked().WritableFd();
+    }
+
+private:
+    static std::size_t CheckedCapacity(int size) {
+        if (size <= 0) {
+            throw std::invalid_argument("BufferedChannel needs capacity > 0, use RendezvousChannel");
+        }
+        return static_cast<std::size_t>(size);
+    }
+
+    bool CanSend() const {
+        return buffer_.Size() < capacity_ || closed_;
+    }
+
+    bool CanRecv() const {
+        return !buffer_.Empty() || closed_;
+    }
+
+    // Ожидания с учетом времени блокировки; часы трогаем, только если ждать пришлось
+    void WaitForSpace(std::unique_lock<std::mutex>& lock) {
+        if (CanSend()) {
+            return;
+        }
+        auto start = stats_.BeginWait();
+        BlockedThreads::Scope queued(blocked_senders_, next_ticket_++);
+        send_waiter_.Wait(lock, [this]() { return CanSend(); });
+        stats_.OnSendBlocked(start);
+    }
+
+    void WaitForItem(std::unique_lock<std::mutex>& lock) {
+        if (CanRecv()) {
+            return;
+        }
+        auto start = stats_.BeginWait();
+        BlockedThreads::Scope queued(blocked_receivers_, next_ticket_++);
+        recv_waiter_.Wait(lock, [this]() { return CanRecv(); });
+        stats_.OnRecvBlocked(start);
+    }
+
+    template<class Clock, class Duration>
+    bool WaitForSpaceUntil(std::unique_lock<std::mutex>& lock,
+                           const std::chrono::time_point<Clock, Duration>& deadline) {
+        if (CanSend()) {
+            return true;
+        }
+        auto start = stats_.BeginWait();
+        BlockedThreads::Scope queued(blocked_senders_, next_ticket_++);
+        bool ready = send_waiter_.WaitUntil(lock, deadline, [this]() { return CanSend(); });
+        stats_.OnSendBlocked(start);
+        return ready;
+    }
+
+    template<class Clock, class Duration>
+    bool WaitForItemUntil(std::unique_lock<std::mutex>& lock,
+                          const std::chrono::time_point<Clock, Duration>& deadline) {
+        if (CanRecv()) {
+            return true;
+        }
+        auto start = stats_.BeginWait();
+        BlockedThreads::Scope queued(blocked_receivers_, next_ticket_++);
+        bool ready = recv_waiter_.WaitUntil(lock, deadline, [this]() { return CanRecv(); });
+        stats_.OnRecvBlocked(start);
+        return ready;
+    }
+
+    // false - результат готов сразу, корутина продолжает без приостановки
+    bool SuspendRecv(RecvNode& node, std::coroutine_handle<> handle) {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        if (!buffer_.Empty()) {
+            node.value.emplace(PopLocked());
+            return false;
+        }
+        if (closed_) {
+            return false;
+        }
+        node.Suspend(handle);
+        node.ticket = next_ticket_++;
+        recv_awaiters_.PushBack(&node);
+        return true;
+    }
+
+    bool SuspendSend(SendNode& node, std::coroutine_handle<> handle) {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        if (closed_) {
+            node.status = ChannelStatus::kClosed;
+            return false;
+        }
+        if (buffer_.Size() < capacity_) {
+            PushLocked(std::move(*node.value));
+            return false;
+        }
+        node.Suspend(handle);
+        node.ticket = next_ticket_++;
+        send_awaiters_.PushBack(&node);
+        return true;
+    }
+
+    // Потоки и корутины обслуживаются в порядке прихода: элемент уходит
+    // корутине, только если ни один поток не ждет дольше нее. Иначе он
+    // остается в буфере, и его забирает разбуженный поток; поэтому вызываем
+    // и после каждого извлечения потоком, и когда поток уходит по таймауту.
+    // Закрытый и пустой канал отдает оставшимся корутинам "закрыт"
+    void ResumeReceiversLocked() {
+        while (!recv_awaiters_.Empty() && !buffer_.Empty()) {
+            if (blocked_receivers_.HasOlderThan(recv_awaiters_.Front()->ticket)) {
+                return;
+            }
+            RecvNode* node = recv_awaiters_.PopFront();
+            node->value.emplace(buffer_.PopFront());
+            stats_.OnRecv(buffer_.Size());
+            node->Resume();
+        }
+        if (closed_ && buffer_.Empty()) {
+            while (!recv_awaiters_.Empty()) {
+                recv_awaiters_.PopFront()->Resume();
+            }
+        }
+    }
+
+    // То же для отправителей: слот достается корутине, только если
+    // заблокированные потоки-отправители пришли позже нее. Вызываем и после
+    // каждой вставки потоком - места может хватить и корутинам за ним
+    void ResumeSendersLocked() {
+        while (!send_awaiters_.Empty() && buffer_.Size() < capacity_) {
+            if (blocked_senders_.HasOlderThan(send_awaiters_.Front()->ticket)) {
+                return;
+            }
+            SendNode* node = send_awaiters_.PopFront();
+            buffer_.Emplace(std::move(*node->value));
+            stats_.OnSend(buffer_.Size());
+            node->Resume();
+        }
+    }
+
+    template<class... Args>
+    void PushLocked(Args&&... args) {
+        buffer_.Emplace(std::forward<Args>(args)...);
+        stats_.OnSend(buffer_.Size());
+        ResumeReceiversLocked();
+        ResumeSendersLocked();
+        if (buffer_.Empty()) {
+            return;
+        }
+        recv_waiter_.NotifyOne();
+        NotifyWatchers();
+    }
+
+    T PopLocked() {
+        T value = buffer_.PopFront();
+        AfterPopLocked();
+        return value;
+    }
+
+    void PopIntoLocked(T& out) {
+        out = std::move(buffer_.Front());
+        buffer_.Pop();
+        AfterPopLocked();
+    }
+
+    void AfterPopLocked() {
+        stats_.OnRecv(buffer_.Size());
+        ResumeSendersLocked();
+        ResumeReceiversLocked();
+        send_waiter_.NotifyOne();
+        NotifyWatchers();
+    }
+
+    void NotifyWatchers() {
+        if (!watchers_.Empty()) {
+            watchers_.NotifyAll();
+        }
+        if (readiness_) {
+            readiness_->Update(CanRecv(), CanSend());
+        }
+    }
+
+    EventFdReadiness& ReadinessLocked() {
+        if (!readiness_) {
+            readiness_ = std::make_unique<EventFdReadiness>(CanRecv(), CanSend());
+        }
+        return *readiness_;
+    }
+
+    // Одно пробуждение на порцию: один элемент - один ждущий, иначе все
+    void NotifyBatch(Waiter& waiter, std::size_t count) {
+        if (count == 1) {
+            waiter.NotifyOne();
+        } else if (count > 1) {
+            waiter.NotifyAll();
+        }
+        if (count > 0) {
+            NotifyWatchers();
+        }
+    }
+
+    // Слоты выделяются один раз в конструкторе, Send/Recv не обращаются к куче
+    const std::size_t capacity_;
+    RingBuffer<T> buffer_;
     bool closed_;
-    std::mutex mtx_;
-    std::condition_variable send_cv_;
-    std::condition_variable recv_cv_;
+    alignas(kCacheLineSize) std::mutex mtx_;
+    Waiter send_waiter_;
+    Waiter recv_waiter_;
+    WatcherList watchers_;
+    AwaitQueue<RecvNode> recv_awaiters_;
+    AwaitQueue<SendNode> send_awaiters_;
+    BlockedThreads blocked_senders_;
+    BlockedThreads blocked_receivers_;
+    uint64_t next_ticket_ = 0;
+    std::unique_ptr<EventFdReadiness> readiness_;
+    [[no_unique_address]] ChannelStats stats_;
 };
 
-#endif // BUFFERED_CHANNEL_H_
\ No newline at end of file
+#endif // BUFFERED_CHANNEL_H_
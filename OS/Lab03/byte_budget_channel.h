@@ -0,0 +1,207 @@
+#ifndef BYTE_BUDGET_CHANNEL_H_
+#define BYTE_BUDGET_CHANNEL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "channel_status.h"
+
+// Размер сообщения по умолчанию: объект плюс его буфер в куче для строк и векторов
+template<class T>
+struct DefaultByteSize {
+    std::size_t operator()(const T&) const { return sizeof(T); }
+};
+
+template<class Char>
+struct DefaultByteSize<std::basic_string<Char>> {
+    std::size_t operator()(const std::basic_string<Char>& value) const {
+        return sizeof(value) + value.capacity() * sizeof(Char);
+    }
+};
+
+template<class U, class Alloc>
+struct DefaultByteSize<std::vector<U, Alloc>> {
+    std::size_t operator()(const std::vector<U, Alloc>& value) const {
+        return sizeof(value) + value.capacity() * sizeof(U);
+    }
+};
+
+struct ByteBudgetMetrics {
+    std::size_t budget = 0;
+    std::size_t bytes_in_flight = 0;
+    std::size_t peak_bytes = 0;
+    std::size_t items = 0;
+    std::size_t senders_waiting = 0;
+    uint64_t blocked_sends = 0;
+};
+
+// Канал, емкость которого - бюджет в байтах, а не число элементов.
+// Размер элемента считает size(value) один раз при отправке.
+//
+// Справедливость: заблокированные отправители встают в очередь по билетам,
+// и вперед пропускается только первый. Мелкие сообщения не обгоняют
+// ждущее крупное, так что оно не голодает. Элемент больше всего бюджета
+// принимается, когда канал пуст, иначе он не прошел бы никогда.
+template<class T, class SizeFn = DefaultByteSize<T>>
+class ByteBudgetChannel {
+public:
+    explicit ByteBudgetChannel(std::size_t budget_bytes, SizeFn size = SizeFn())
+        : budget_(CheckedBudget(budget_bytes)), size_(std::move(size)) {}
+
+    void Send(T value) {
+        std::size_t bytes = size_(value);
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        if (waiting_ > 0 || !FitsLocked(bytes)) {
+            uint64_t ticket = next_ticket_++;
+            ++waiting_;
+            ++blocked_sends_;
+            send_cv_.wait(lock, [this, ticket, bytes]() {
+                return closed_ || (ticket == serving_ticket_ && FitsLocked(bytes));
+            });
+            --waiting_;
+            if (closed_) {
+                throw std::runtime_error("Channel is closed");
+            }
+            // Очередь сдвинулась: следующий билет, возможно, тоже помещается
+            ++serving_ticket_;
+            if (waiting_ > 0) {
+                send_cv_.notify_all();
+            }
+        }
+        if (closed_) {
+            throw std::runtime_error("Channel is closed");
+        }
+        PushLocked(std::move(value), bytes);
+    }
+
+    // kFull - не помещается или есть очередь ждущих отправителей
+    ChannelStatus TrySend(T&& value) {
+        std::size_t bytes = size_(value);
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        if (closed_) {
+            return ChannelStatus::kClosed;
+        }
+        if (waiting_ > 0 || !FitsLocked(bytes)) {
+            return ChannelStatus::kFull;
+        }
+        PushLocked(std::move(value), bytes);
+        return ChannelStatus::kOk;
+    }
+
+    std::pair<T, bool> Recv() {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        ++recv_waiters_;
+        recv_cv_.wait(lock, [this]() {
+            return !items_.empty() || closed_;
+        });
+        --recv_waiters_;
+
+        if (items_.empty()) {
+            return {T(), false};
+        }
+        return {PopLocked(), true};
+    }
+
+    ChannelStatus TryRecv(T& out) {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        if (items_.empty()) {
+            return closed_ ? ChannelStatus::kClosed : ChannelStatus::kEmpty;
+        }
+        out = PopLocked();
+        return ChannelStatus::kOk;
+    }
+
+    void Close() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        closed_ = true;
+        send_cv_.notify_all();
+        recv_cv_.notify_all();
+    }
+
+    std::size_t BytesInFlight() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        return bytes_;
+    }
+
+    ByteBudgetMetrics Metrics() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        ByteBudgetMetrics metrics;
+        metrics.budget = budget_;
+        metrics.bytes_in_flight = bytes_;
+        metrics.peak_bytes = peak_bytes_;
+        metrics.items = items_.size();
+        metrics.senders_waiting = waiting_;
+        metrics.blocked_sends = blocked_sends_;
+        return metrics;
+    }
+
+private:
+    // Как CheckedCapacity у остальных каналов
+    static std::size_t CheckedBudget(std::size_t budget_bytes) {
+        if (budget_bytes == 0) {
+            throw std::invalid_argument("ByteBudgetChannel needs budget > 0");
+        }
+        return budget_bytes;
+    }
+
+    struct Item {
+        T value;
+        std::size_t bytes;
+    };
+
+    bool FitsLocked(std::size_t bytes) const {
+        return bytes_ + bytes <= budget_ || items_.empty();
+    }
+
+    void PushLocked(T&& value, std::size_t bytes) {
+        items_.push_back(Item{std::move(value), bytes});
+        bytes_ += bytes;
+        if (bytes_ > peak_bytes_) {
+            peak_bytes_ = bytes_;
+        }
+        if (recv_waiters_ > 0) {
+            recv_cv_.notify_one();
+        }
+    }
+
+    // Освобожденные байты может взять только первый в очереди, но условные
+    // переменные не адресные - будим всех, лишние снова уснут
+    T PopLocked() {
+        Item item = std::move(items_.front());
+        items_.pop_front();
+        bytes_ -= item.bytes;
+        if (waiting_ > 0) {
+            send_cv_.notify_all();
+        }
+        return std::move(item.value);
+    }
+
+    const std::size_t budget_;
+    SizeFn size_;
+
+    std::mutex mtx_;
+    std::condition_variable send_cv_;
+    std::condition_variable recv_cv_;
+    std::deque<Item> items_;
+    std::size_t bytes_ = 0;
+    std::size_t peak_bytes_ = 0;
+    std::size_t waiting_ = 0;
+    int recv_waiters_ = 0;
+    uint64_t next_ticket_ = 0;
+    uint64_t serving_ticket_ = 0;
+    uint64_t blocked_sends_ = 0;
+    bool closed_ = false;
+};
+
+#endif // BYTE_BUDGET_CHANNEL_H_
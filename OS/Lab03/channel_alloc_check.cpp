@@ -0,0 +1,105 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <array>
+#include <cstdlib>
+#include <new>
+
+#include "alloc_counter.h"
+#include "buhhered_channel.h"
+#include "channel_waiter.h"
+
+// Проверка обещания ring_buffer.h: после конструктора Send/Recv не обращаются
+// к куче. Глобальный operator new считает выделения; каждый сценарий
+// создает канал и потоки заранее и считает только сами передачи -
+// с переходом через конец кольца, полным и пустым каналом и ждущей второй стороной.
+// Код возврата 1, если счетчик сдвинулся хоть в одном сценарии.
+//
+//   g++ -std=c++20 -O2 -pthread channel_alloc_check.cpp -o channel_alloc_check
+
+struct Message {
+    std::array<char, 256> data{};
+    int index = 0;
+};
+
+static bool Fail(const std::string& name, const std::string& reason) {
+    std::cout << "FAIL  " << name << ": " << reason << std::endl;
+    return false;
+}
+
+static bool Report(const std::string& name, long long allocations) {
+    std::cout << (allocations == 0 ? "ok    " : "FAIL  ") << name
+              << ": " << allocations << " allocations" << std::endl;
+    return allocations == 0;
+}
+
+// Один поток: емкость 3 (кольцо на 4), так что голова и хвост многократно
+// переходят через конец, а канал каждый раз становится полным и пустым
+template<class T, class Waiter>
+bool CheckWrapAround(const std::string& name, int rounds) {
+    BufferedChannel<T, Waiter> channel(3);
+    long long before = g_allocations.load();
+
+    for (int i = 0; i < rounds; i++) {
+        for (int k = 0; k < 3; k++) {
+            channel.Send(T{});
+        }
+        T out{};
+        if (channel.TrySend(out) != ChannelStatus::kFull) return Fail(name, "expected kFull");
+        for (int k = 0; k < 3; k++) {
+            channel.Recv();
+        }
+        if (channel.TryRecv(out) != ChannelStatus::kEmpty) return Fail(name, "expected kEmpty");
+    }
+    return Report(name + " wrap-around", g_allocations.load() - before);
+}
+
+// Два потока через емкость 1: отправитель упирается в полный канал,
+// получатель - в пустой, оба регулярно засыпают и будят друг друга
+template<class T, class Waiter>
+bool CheckBlockedPeer(const std::string& name, int messages) {
+    BufferedChannel<T, Waiter> channel(1);
+    std::atomic<bool> ready(false);
+    std::atomic<bool> go(false);
+    long long received = 0;
+
+    std::thread consumer([&]() {
+        ready.store(true);
+        while (!go.load()) std::this_thread::yield();
+        T out{};
+        while (channel.RecvInto(out)) {
+            received++;
+        }
+    });
+    while (!ready.load()) std::this_thread::yield();
+
+    long long before = g_allocations.load();
+    go.store(true);
+    for (int i = 0; i < messages; i++) {
+        channel.Send(T{});
+    }
+    channel.Close();
+    long long allocations = g_allocations.load() - before;
+    consumer.join();
+
+    if (received != messages) {
+        return Fail(name, "lost messages");
+    }
+    return Report(name + " blocked peer", allocations);
+}
+
+template<class T, class Waiter = CondVarWaiter>
+bool CheckChannel(const std::string& name) {
+    bool ok = CheckWrapAround<T, Waiter>(name, 100000);
+    ok = CheckBlockedPeer<T, Waiter>(name, 100000) && ok;
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+    ok = CheckChannel<int>("BufferedChannel<int>") && ok;
+    ok = CheckChannel<Message>("BufferedChannel<Message>") && ok;
+    ok = CheckChannel<int, SpinFutexWaiter>("BufferedChannel<int, SpinFutex>") && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#ifndef CHANNEL_AWAITERS_H_
+#define CHANNEL_AWAITERS_H_
+
+#include <coroutine>
+#include <cstdint>
+#include <stdexcept>
+
+#include "coro_executor.h"
+
+// Приостановленная на канале корутина. Узел живет в кадре корутины
+// (внутри объекта-awaiter), поэтому очередь ожидания не выделяет память.
+struct AwaitNode {
+    std::coroutine_handle<> handle;
+    Executor* executor = nullptr;
+    AwaitNode* next = nullptr;
+    // Номер в общей с потоками очереди ожидания (см. BlockedThreads)
+    uint64_t ticket = 0;
+
+    void Suspend(std::coroutine_handle<> h) {
+        executor = Executor::Current();
+        if (!executor) {
+            throw std::logic_error("Channel awaited outside of an Executor");
+        }
+        handle = h;
+    }
+
+    // После вызова узел больше трогать нельзя: корутина может уже выполняться
+    void Resume() { executor->Schedule(handle); }
+};
+
+// Интрузивная FIFO-очередь узлов; вызывается под мьютексом канала
+template<class Node>
+class AwaitQueue {
+public:
+    void PushBack(Node* node) {
+        node->next = nullptr;
+        if (tail_) {
+            tail_->next = node;
+        } else {
+            head_ = node;
+        }
+        tail_ = node;
+    }
+
+    Node* Front() const { return head_; }
+
+    Node* PopFront() {
+        Node* node = head_;
+        head_ = static_cast<Node*>(node->next);
+        if (!head_) {
+            tail_ = nullptr;
+        }
+        return node;
+    }
+
+    bool Empty() const { return head_ == nullptr; }
+
+private:
+    Node* head_ = nullptr;
+    Node* tail_ = nullptr;
+};
+
+// Потоки, ждущие в Wait* канала, в порядке прихода. Номера берутся из того же
+// счетчика, что и ticket корутин, так что канал может отдать место или элемент
+// тому, кто ждет дольше, а не всегда корутинам. Узлы на стеке ждущего потока,
+// список меняется только под мьютексом канала.
+class BlockedThreads {
+public:
+    struct Entry {
+        uint64_t ticket;
+        Entry* prev = nullptr;
+        Entry* next = nullptr;
+    };
+
+    // Регистрирует поток на время ожидания; создавать и уничтожать под мьютексом
+    class Scope {
+    public:
+        Scope(BlockedThreads& list, uint64_t ticket) : list_(list), entry_{ticket} {
+            list_.PushBack(&entry_);
+        }
+        ~Scope() { list_.Remove(&entry_); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        BlockedThreads& list_;
+        Entry entry_;
+    };
+
+    // true - какой-то поток ждет дольше узла с этим номером
+    bool HasOlderThan(uint64_t ticket) const {
+        return head_ != nullptr && head_->ticket < ticket;
+    }
+
+private:
+    void PushBack(Entry* entry) {
+        entry->prev = tail_;
+        if (tail_) {
+            tail_->next = entry;
+        } else {
+            head_ = entry;
+        }
+        tail_ = entry;
+    }
+
+    void Remove(Entry* entry) {
+        (entry->prev ? entry->prev->next : head_) = entry->next;
+        (entry->next ? entry->next->prev : tail_) = entry->prev;
+    }
+
+    Entry* head_ = nullptr;
+    Entry* tail_ = nullptr;
+};
+
+#endif // CHANNEL_AWAITERS_H_
@@ -0,0 +1,1391 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <memory>
+#include <ctime>
+#include <array>
+#include <map>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "alloc_counter.h"
+#include "broadcast_channel.h"
+#include "buffer_pool.h"
+#include "buhhered_channel.h"
+#include "byte_budget_channel.h"
+#include "spsc_channel.h"
+#include "timer_service.h"
+#include "mpmc_channel.h"
+#include "priority_channel.h"
+#include "rendezvous_channel.h"
+#include "select.h"
+#include "sharded_channel.h"
+#include "shm_channel.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double SecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Один отправитель, один получатель, messages сообщений
+template<class Channel>
+double MeasureThroughput(int capacity, int messages) {
+    Channel channel(capacity);
+    auto start = Clock::now();
+
+    std::thread producer([&]() {
+        for (int i = 0; i < messages; i++) {
+            channel.Send(i);
+        }
+        channel.Close();
+    });
+
+    long long sum = 0;
+    while (true) {
+        auto [value, ok] = channel.Recv();
+        if (!ok) break;
+        sum += value;
+    }
+    producer.join();
+
+    double seconds = SecondsSince(start);
+    if (sum != 1LL * messages * (messages - 1) / 2) {
+        std::cerr << "Lost messages" << std::endl;
+    }
+    return messages / seconds;
+}
+
+// Пинг-понг через два канала, среднее время круга в наносекундах
+template<class Channel>
+double MeasureRoundTrip(int rounds) {
+    Channel ping(1);
+    Channel pong(1);
+
+    std::thread echo([&]() {
+        while (true) {
+            auto [value, ok] = ping.Recv();
+            if (!ok) break;
+            pong.Send(value);
+        }
+    });
+
+    auto start = Clock::now();
+    for (int i = 0; i < rounds; i++) {
+        ping.Send(i);
+        pong.Recv();
+    }
+    double seconds = SecondsSince(start);
+
+    ping.Close();
+    echo.join();
+    return seconds * 1e9 / rounds;
+}
+
+template<class Channel>
+void PrintSpscRow(const std::string& name, int messages, int rounds) {
+    for (int capacity : {1, 16, 1024}) {
+        std::cout << std::setw(20) << name
+                  << std::setw(12) << capacity
+                  << std::setw(20) << static_cast<long long>(MeasureThroughput<Channel>(capacity, messages))
+                  << std::setw(20) << static_cast<long long>(MeasureRoundTrip<Channel>(rounds))
+                  << std::endl;
+    }
+}
+
+void BenchSpsc() {
+    const int messages = 2000000;
+    const int rounds = 100000;
+
+    std::cout << "\n=== SPSC: mutex channel vs lock-free ring ===\n";
+    std::cout << std::setw(20) << "Channel"
+              << std::setw(12) << "Capacity"
+              << std::setw(20) << "Messages/sec"
+              << std::setw(20) << "Round trip (ns)"
+              << std::endl;
+
+    PrintSpscRow<BufferedChannel<int>>("BufferedChannel", messages, rounds);
+    PrintSpscRow<SpscChannel<int>>("SpscChannel", messages, rounds);
+}
+
+// producers отправителей и consumers получателей делят messages сообщений
+template<class Channel>
+double MeasureContention(int producers, int consumers, int capacity, int messages) {
+    Channel channel(capacity);
+    std::atomic<long long> received(0);
+    auto start = Clock::now();
+
+    std::vector<std::thread> threads;
+    for (int c = 0; c < consumers; c++) {
+        threads.emplace_back([&]() {
+            long long count = 0;
+            while (channel.Recv().second) count++;
+            received += count;
+        });
+    }
+
+    std::vector<std::thread> senders;
+    for (int p = 0; p < producers; p++) {
+        int begin = static_cast<int>(1LL * messages * p / producers);
+        int end   = static_cast<int>(1LL * messages * (p + 1) / producers);
+        senders.emplace_back([&channel, begin, end]() {
+            for (int i = begin; i < end; i++) channel.Send(i);
+        });
+    }
+    for (auto& sender : senders) sender.join();
+    channel.Close();
+    for (auto& thread : threads) thread.join();
+
+    double seconds = SecondsSince(start);
+    if (received != messages) {
+        std::cerr << "Lost messages" << std::endl;
+    }
+    return messages / seconds;
+}
+
+void BenchMpmc() {
+    const int messages = 1000000;
+    const int capacity = 1024;
+
+    std::cout << "\n=== MPMC contention: mutex channel vs sequence slots ===\n";
+    std::cout << std::setw(10) << "Threads"
+              << std::setw(12) << "Producers"
+              << std::setw(12) << "Consumers"
+              << std::setw(25) << "BufferedChannel msg/s"
+              << std::setw(25) << "MpmcChannel msg/s"
+              << std::endl;
+
+    for (int threads : {2, 4, 8, 16, 32, 64}) {
+        int producers = std::max(1, threads / 2);
+        int consumers = std::max(1, threads - producers);
+        std::cout << std::setw(10) << threads
+                  << std::setw(12) << producers
+                  << std::setw(12) << consumers
+                  << std::setw(25) << static_cast<long long>(
+                         MeasureContention<BufferedChannel<int>>(producers, consumers, capacity, messages))
+                  << std::setw(25) << static_cast<long long>(
+                         MeasureContention<MpmcChannel<int>>(producers, consumers, capacity, messages))
+                  << std::endl;
+    }
+}
+
+// Нс на операцию для body(i), повторенного iterations раз
+template<class Body>
+double NanosPerOp(int iterations, Body body) {
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        body(i);
+    }
+    return SecondsSince(start) * 1e9 / iterations;
+}
+
+void BenchStatus() {
+    const int iterations = 200000;
+
+    std::cout << "\n=== Exception-free status API vs throwing Send ===\n";
+    std::cout << std::setw(40) << "Case"
+              << std::setw(20) << "ns/op"
+              << std::endl;
+
+    auto row = [](const std::string& name, double ns) {
+        std::cout << std::setw(40) << name << std::setw(20) << ns << std::endl;
+    };
+
+    // Закрытый канал: исключение против кода возврата
+    BufferedChannel<int> closed(16);
+    closed.Close();
+    int rejected = 0;
+    row("closed: Send + catch", NanosPerOp(iterations, [&](int i) {
+        try {
+            closed.Send(i);
+        } catch (const std::runtime_error&) {
+            rejected++;
+        }
+    }));
+    row("closed: TrySend -> kClosed", NanosPerOp(iterations, [&](int i) {
+        if (closed.TrySend(i) == ChannelStatus::kClosed) rejected++;
+    }));
+
+    // Полный канал: сброс нагрузки без ожидания
+    BufferedChannel<int> full(16);
+    for (int i = 0; i < 16; i++) full.Send(i);
+    row("full: TrySend -> kFull", NanosPerOp(iterations, [&](int i) {
+        if (full.TrySend(i) == ChannelStatus::kFull) rejected++;
+    }));
+    row("full: SendFor(0) -> kTimeout", NanosPerOp(iterations, [&](int i) {
+        if (full.SendFor(i, std::chrono::nanoseconds(0)) == ChannelStatus::kTimeout) rejected++;
+    }));
+
+    // Обычный путь в одном потоке: отправка и сразу получение
+    BufferedChannel<int> open(16);
+    int value = 0;
+    row("open: Send + Recv", NanosPerOp(iterations, [&](int i) {
+        open.Send(i);
+        value += open.Recv().first;
+    }));
+    row("open: TrySend + TryRecv", NanosPerOp(iterations, [&](int i) {
+        open.TrySend(i);
+        int out;
+        if (open.TryRecv(out) == ChannelStatus::kOk) value += out;
+    }));
+
+    if (rejected == 0 || value == -1) {
+        std::cerr << "Unexpected result" << std::endl;
+    }
+}
+
+// Один получатель через Select на channels каналах, у каждого свой отправитель.
+// Закрытые каналы убираются из Select. Доли каналов (мин/макс от среднего)
+// считаются по первой половине сообщений, пока все отправители еще активны.
+void MeasureSelect(int channels, int messages) {
+    const int per_channel = messages / channels;
+    const long long total = 1LL * per_channel * channels;
+
+    std::vector<std::unique_ptr<BufferedChannel<int>>> inputs;
+    for (int c = 0; c < channels; c++) {
+        inputs.push_back(std::make_unique<BufferedChannel<int>>(64));
+    }
+
+    auto start = Clock::now();
+    std::vector<std::thread> producers;
+    for (int c = 0; c < channels; c++) {
+        producers.emplace_back([&inputs, c, per_channel]() {
+            for (int i = 0; i < per_channel; i++) inputs[c]->Send(i);
+            inputs[c]->Close();
+        });
+    }
+
+    std::vector<int> values(channels);
+    std::unique_ptr<bool[]> oks(new bool[channels]);
+    std::vector<SelectCase> cases;
+    std::vector<int> owner;
+    for (int c = 0; c < channels; c++) {
+        cases.push_back(SelectCase::Recv(*inputs[c], values[c], &oks[c]));
+        owner.push_back(c);
+    }
+
+    std::vector<long long> share(channels, 0);
+    long long received = 0;
+    while (!cases.empty()) {
+        int chosen = Select(cases);
+        int c = owner[chosen];
+        if (!oks[c]) {
+            cases[chosen] = cases.back();
+            cases.pop_back();
+            owner[chosen] = owner.back();
+            owner.pop_back();
+            continue;
+        }
+        if (received < total / 2) share[c]++;
+        received++;
+    }
+    double seconds = SecondsSince(start);
+    for (auto& producer : producers) producer.join();
+
+    if (received != total) {
+        std::cerr << "Lost messages" << std::endl;
+    }
+    double mean = static_cast<double>(total / 2) / channels;
+    auto [min_share, max_share] = std::minmax_element(share.begin(), share.end());
+    std::cout << std::setw(10) << channels
+              << std::setw(20) << static_cast<long long>(received / seconds)
+              << std::setw(15) << std::fixed << std::setprecision(2) << *min_share / mean
+              << std::setw(15) << *max_share / mean
+              << std::defaultfloat << std::endl;
+}
+
+void BenchSelect() {
+    const int messages = 1000000;
+
+    std::cout << "\n=== Select over N channels, one producer each ===\n";
+    std::cout << std::setw(10) << "Channels"
+              << std::setw(20) << "Messages/sec"
+              << std::setw(15) << "Min share"
+              << std::setw(15) << "Max share"
+              << std::endl;
+
+    for (int channels : {2, 8, 64}) {
+        MeasureSelect(channels, messages);
+    }
+}
+
+// Процессорное время всех потоков процесса в секундах
+static double ProcessCpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Пинг-понг через два канала: задержка каждого круга и
+// процессорное время на круг (включая кручение ожидающей стороны)
+template<class Channel>
+void MeasurePingPong(const std::string& name, int rounds, Channel& ping, Channel& pong) {
+    std::thread echo([&]() {
+        while (true) {
+            auto [value, ok] = ping.Recv();
+            if (!ok) break;
+            pong.Send(value);
+        }
+    });
+
+    // Верхние границы корзин гистограммы в нс, последняя - все остальное
+    const std::vector<long long> bounds = {1000, 2000, 5000, 10000, 20000, 50000, 100000};
+    std::vector<long long> histogram(bounds.size() + 1, 0);
+    std::vector<long long> latencies(rounds);
+
+    double cpu_start = ProcessCpuSeconds();
+    for (int i = 0; i < rounds; i++) {
+        auto start = Clock::now();
+        ping.Send(i);
+        pong.Recv();
+        latencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        std::size_t bucket = std::upper_bound(bounds.begin(), bounds.end(), latencies[i] - 1) - bounds.begin();
+        histogram[bucket]++;
+    }
+    double cpu_seconds = ProcessCpuSeconds() - cpu_start;
+
+    ping.Close();
+    echo.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << std::setw(22) << name
+              << std::setw(10) << latencies[rounds / 2]
+              << std::setw(10) << latencies[rounds * 99 / 100]
+              << std::setw(12) << static_cast<long long>(cpu_seconds * 1e9 / rounds);
+    for (long long count : histogram) {
+        std::cout << std::setw(8) << std::fixed << std::setprecision(1)
+                  << 100.0 * count / rounds << std::defaultfloat;
+    }
+    std::cout << std::endl;
+}
+
+template<class Channel>
+void MeasureWaitStrategy(const std::string& name, int rounds,
+                         const typename Channel::WaitOptions& options) {
+    Channel ping(1, options);
+    Channel pong(1, options);
+    MeasurePingPong(name, rounds, ping, pong);
+}
+
+static void PrintPingPongHeader(const std::string& first_column) {
+    std::cout << std::setw(22) << first_column
+              << std::setw(10) << "p50 ns"
+              << std::setw(10) << "p99 ns"
+              << std::setw(12) << "CPU ns/rt"
+              << std::setw(8) << "<1us%" << std::setw(8) << "<2us%"
+              << std::setw(8) << "<5us%" << std::setw(8) << "<10us%"
+              << std::setw(8) << "<20us%" << std::setw(8) << "<50us%"
+              << std::setw(8) << "<100us%" << std::setw(8) << ">100us%"
+              << std::endl;
+}
+
+void BenchWait() {
+    const int rounds = 100000;
+
+    std::cout << "\n=== Wait strategy: condvar vs spin-then-futex (ping-pong, capacity 1) ===\n";
+    PrintPingPongHeader("Strategy");
+
+    MeasureWaitStrategy<BufferedChannel<int>>("condvar", rounds, {});
+    for (int spin : {0, 100, 1000, 10000}) {
+        SpinFutexOptions options;
+        options.spin_iterations = spin;
+        MeasureWaitStrategy<BufferedChannel<int, SpinFutexWaiter>>(
+            "spin " + std::to_string(spin) + " + futex", rounds, options);
+    }
+}
+
+// Конвейер источник -> быстрая стадия -> медленная стадия -> сток.
+// Монитор раз в 100 мс печатает снимки обоих каналов: узкое место - тот канал,
+// что стоит полным, а его отправители копят время блокировки.
+void BenchStats() {
+    const int messages = 200000;
+
+    std::cout << "\n=== Channel instrumentation (pipeline with a slow stage) ===\n";
+
+    BufferedChannel<int> raw(256);
+    BufferedChannel<int> parsed(256);
+    std::atomic<bool> done(false);
+
+    std::thread source([&]() {
+        for (int i = 0; i < messages; i++) raw.Send(i);
+        raw.Close();
+    });
+    std::thread fast([&]() {
+        while (true) {
+            auto [value, ok] = raw.Recv();
+            if (!ok) break;
+            parsed.Send(value + 1);
+        }
+        parsed.Close();
+    });
+    std::thread slow([&]() {
+        long long sum = 0;
+        while (true) {
+            auto [value, ok] = parsed.Recv();
+            if (!ok) break;
+            // Имитация дорогой обработки
+            for (int k = 0; k < 200; k++) sum += (value ^ k) % 7;
+        }
+        done = true;
+        if (sum == -1) std::cerr << "Unexpected result" << std::endl;
+    });
+
+    auto raw_last = raw.Stats();
+    auto parsed_last = parsed.Stats();
+    while (!done) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        auto raw_now = raw.Stats();
+        auto parsed_now = parsed.Stats();
+        std::cout << "raw    " << raw_now.Since(raw_last) << "\n"
+                  << "parsed " << parsed_now.Since(parsed_last) << std::endl;
+        raw_last = raw_now;
+        parsed_last = parsed_now;
+    }
+    source.join();
+    fast.join();
+    slow.join();
+
+    std::cout << "total raw    " << raw.Stats() << "\n"
+              << "total parsed " << parsed.Stats() << std::endl;
+
+    // Цена инструментации: сравнить сборки с -DCHANNEL_STATS и без
+    BufferedChannel<int> channel(16);
+    int value = 0;
+    std::cout << "Send + Recv, one thread: " << NanosPerOp(1000000, [&](int i) {
+        channel.Send(i);
+        value += channel.Recv().first;
+    }) << " ns/op" << std::endl;
+}
+
+Task CoroProducer(BufferedChannel<int>& channel, int messages) {
+    for (int i = 0; i < messages; i++) {
+        co_await channel.AsyncSend(i);
+    }
+}
+
+Task CoroConsumer(BufferedChannel<int>& channel, int messages, std::atomic<long long>& received) {
+    for (int i = 0; i < messages; i++) {
+        auto [value, ok] = co_await channel.AsyncRecv();
+        if (!ok) break;
+    }
+    received += messages;
+}
+
+// tasks корутин-отправителей и столько же получателей на channels каналах,
+// каждая корутина передает per_task сообщений; потоков - по числу ядер
+double MeasureCoroutines(int tasks, int channels, int per_task) {
+    std::vector<std::unique_ptr<BufferedChannel<int>>> pipes;
+    for (int c = 0; c < channels; c++) {
+        pipes.push_back(std::make_unique<BufferedChannel<int>>(16));
+    }
+    std::atomic<long long> received(0);
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto start = Clock::now();
+    {
+        Executor executor(threads);
+        for (int t = 0; t < tasks; t++) {
+            executor.Spawn(CoroConsumer(*pipes[t % channels], per_task, received));
+            executor.Spawn(CoroProducer(*pipes[t % channels], per_task));
+        }
+        executor.WaitIdle();
+    }
+    double seconds = SecondsSince(start);
+
+    if (received != 1LL * tasks * per_task) {
+        std::cerr << "Lost messages" << std::endl;
+    }
+    return received / seconds;
+}
+
+// То же на блокирующих потоках: по потоку-отправителю и получателю на канал
+double MeasureThreads(int channels, long long messages) {
+    std::vector<std::unique_ptr<BufferedChannel<int>>> pipes;
+    for (int c = 0; c < channels; c++) {
+        pipes.push_back(std::make_unique<BufferedChannel<int>>(16));
+    }
+    int per_channel = static_cast<int>(messages / channels);
+
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int c = 0; c < channels; c++) {
+        threads.emplace_back([&pipes, c, per_channel]() {
+            for (int i = 0; i < per_channel; i++) pipes[c]->Send(i);
+        });
+        threads.emplace_back([&pipes, c, per_channel]() {
+            for (int i = 0; i < per_channel; i++) pipes[c]->Recv();
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    return 1LL * per_channel * channels / SecondsSince(start);
+}
+
+static long MaxRssKb() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+void BenchCoroutines() {
+    const int channels = 64;
+    const int per_task = 20;
+
+    std::cout << "\n=== Coroutines vs threads (" << channels << " channels, capacity 16) ===\n";
+    std::cout << std::setw(30) << "Mode"
+              << std::setw(20) << "Messages/sec"
+              << std::setw(20) << "Max RSS (KB)"
+              << std::endl;
+
+    for (int tasks : {1000, 10000, 50000}) {
+        double rate = MeasureCoroutines(tasks, channels, per_task);
+        std::cout << std::setw(30) << std::to_string(2 * tasks) + " coroutines"
+                  << std::setw(20) << static_cast<long long>(rate)
+                  << std::setw(20) << MaxRssKb()
+                  << std::endl;
+    }
+    double rate = MeasureThreads(channels, 1LL * 50000 * per_task);
+    std::cout << std::setw(30) << std::to_string(2 * channels) + " threads"
+              << std::setw(20) << static_cast<long long>(rate)
+              << std::setw(20) << MaxRssKb()
+              << std::endl;
+}
+
+template<std::size_t kBytes>
+struct Payload {
+    std::array<char, kBytes> data;
+};
+
+static void WriteFull(int fd, const void* data, std::size_t size) {
+    const char* ptr = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, ptr, size);
+        if (written <= 0) {
+            if (written == -1 && errno == EINTR) continue;
+            return;
+        }
+        ptr += written;
+        size -= written;
+    }
+}
+
+static bool ReadFull(int fd, void* data, std::size_t size) {
+    char* ptr = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t got = read(fd, ptr, size);
+        if (got <= 0) {
+            if (got == -1 && errno == EINTR) continue;
+            return false;
+        }
+        ptr += got;
+        size -= got;
+    }
+    return true;
+}
+
+// Дочерний процесс читает messages сообщений; время до его завершения
+template<std::size_t kBytes>
+double MeasurePipe(int messages) {
+    int fds[2];
+    if (pipe(fds) == -1) return 0;
+
+    auto start = Clock::now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[1]);
+        Payload<kBytes> message;
+        long long sum = 0;
+        while (ReadFull(fds[0], &message, sizeof(message))) sum += message.data[0];
+        _exit(sum == 0 ? 0 : 1);
+    }
+    close(fds[0]);
+    Payload<kBytes> message{};
+    for (int i = 0; i < messages; i++) {
+        WriteFull(fds[1], &message, sizeof(message));
+    }
+    close(fds[1]);
+    waitpid(pid, nullptr, 0);
+    return messages / SecondsSince(start);
+}
+
+template<std::size_t kBytes>
+double MeasureShm(int messages) {
+    auto channel = ShmChannel<Payload<kBytes>>::CreateAnonymous(64);
+
+    auto start = Clock::now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        channel.Attach();
+        long long sum = 0;
+        while (true) {
+            auto [message, ok] = channel.Recv();
+            if (!ok) break;
+            sum += message.data[0];
+        }
+        _exit(sum == 0 ? 0 : 1);
+    }
+    Payload<kBytes> message{};
+    for (int i = 0; i < messages; i++) {
+        channel.Send(message);
+    }
+    channel.Close();
+    waitpid(pid, nullptr, 0);
+    return messages / SecondsSince(start);
+}
+
+template<std::size_t kBytes>
+void PrintShmRow(int messages) {
+    double pipe_rate = MeasurePipe<kBytes>(messages);
+    double shm_rate = MeasureShm<kBytes>(messages);
+    std::cout << std::setw(12) << kBytes
+              << std::setw(20) << static_cast<long long>(pipe_rate)
+              << std::setw(20) << static_cast<long long>(shm_rate)
+              << std::setw(15) << static_cast<long long>(pipe_rate * kBytes / (1 << 20))
+              << std::setw(15) << static_cast<long long>(shm_rate * kBytes / (1 << 20))
+              << std::endl;
+}
+
+void BenchShm() {
+    std::cout << "\n=== Between processes: pipe vs ShmChannel (capacity 64) ===\n";
+    std::cout << std::setw(12) << "Bytes"
+              << std::setw(20) << "Pipe msg/s"
+              << std::setw(20) << "Shm msg/s"
+              << std::setw(15) << "Pipe MB/s"
+              << std::setw(15) << "Shm MB/s"
+              << std::endl;
+
+    PrintShmRow<8>(1000000);
+    PrintShmRow<256>(500000);
+    PrintShmRow<4096>(100000);
+    PrintShmRow<65536>(10000);
+}
+
+// Один отправитель, subscribers подписчиков-потоков; доставок в секунду
+// (сообщение, полученное каждым из N подписчиков, считается N раз)
+double MeasureBroadcast(int subscribers, int messages, OverflowPolicy policy, double* drop_share) {
+    BroadcastChannel<int> channel(1024, policy);
+    std::vector<std::thread> threads;
+    std::atomic<int> ready(0);
+    std::atomic<long long> delivered(0);
+    std::atomic<long long> dropped(0);
+
+    for (int s = 0; s < subscribers; s++) {
+        threads.emplace_back([&]() {
+            auto subscription = channel.Subscribe();
+            ready++;
+            long long count = 0;
+            while (subscription.Recv().second) count++;
+            delivered += count;
+            dropped += subscription.Dropped();
+        });
+    }
+    while (ready < subscribers) std::this_thread::yield();
+
+    auto start = Clock::now();
+    for (int i = 0; i < messages; i++) channel.Send(i);
+    channel.Close();
+    for (auto& thread : threads) thread.join();
+    double seconds = SecondsSince(start);
+
+    if (delivered + dropped != 1LL * messages * subscribers) {
+        std::cerr << "Lost messages" << std::endl;
+    }
+    *drop_share = 100.0 * dropped / (1LL * messages * subscribers);
+    return delivered / seconds;
+}
+
+// То же через N отдельных BufferedChannel: отправитель кладет копию в каждый
+double MeasureFanOutCopies(int subscribers, int messages) {
+    std::vector<std::unique_ptr<BufferedChannel<int>>> channels;
+    for (int s = 0; s < subscribers; s++) {
+        channels.push_back(std::make_unique<BufferedChannel<int>>(1024));
+    }
+    std::vector<std::thread> threads;
+    std::atomic<long long> delivered(0);
+    for (int s = 0; s < subscribers; s++) {
+        threads.emplace_back([&channels, &delivered, s]() {
+            long long count = 0;
+            while (channels[s]->Recv().second) count++;
+            delivered += count;
+        });
+    }
+
+    auto start = Clock::now();
+    for (int i = 0; i < messages; i++) {
+        for (auto& channel : channels) channel->Send(i);
+    }
+    for (auto& channel : channels) channel->Close();
+    for (auto& thread : threads) thread.join();
+    return delivered / SecondsSince(start);
+}
+
+void BenchBroadcast() {
+    const int messages = 200000;
+
+    std::cout << "\n=== Broadcast: shared ring vs N BufferedChannels (deliveries/sec) ===\n";
+    std::cout << std::setw(13) << "Subscribers"
+              << std::setw(20) << "N channels"
+              << std::setw(20) << "Broadcast block"
+              << std::setw(20) << "Broadcast drop"
+              << std::setw(12) << "Dropped %"
+              << std::endl;
+
+    for (int subscribers : {1, 2, 4, 8, 16}) {
+        double drop_share = 0;
+        double copies = MeasureFanOutCopies(subscribers, messages);
+        double blocking = MeasureBroadcast(subscribers, messages, OverflowPolicy::kBlock, &drop_share);
+        double dropping = MeasureBroadcast(subscribers, messages, OverflowPolicy::kDropOldest, &drop_share);
+        std::cout << std::setw(13) << subscribers
+                  << std::setw(20) << static_cast<long long>(copies)
+                  << std::setw(20) << static_cast<long long>(blocking)
+                  << std::setw(20) << static_cast<long long>(dropping)
+                  << std::setw(12) << std::fixed << std::setprecision(1) << drop_share
+                  << std::defaultfloat << std::endl;
+    }
+}
+
+struct TimedMessage {
+    Clock::time_point sent;
+    bool control = false;
+};
+
+// Насыщенный канал: массовый отправитель держит очередь полной, получатель
+// тратит ~work_ns на сообщение, раз в миллисекунду приходит служебное сообщение.
+// Возвращает задержки служебных сообщений (мкс), отсортированные
+template<class SendBulk, class SendControl, class RecvOne, class CloseAll>
+std::vector<double> MeasureControlLatency(SendBulk send_bulk, SendControl send_control,
+                                          RecvOne recv, CloseAll close, int controls) {
+    std::atomic<bool> stop(false);
+    std::thread bulk([&]() {
+        while (!stop) send_bulk(TimedMessage{Clock::now(), false});
+    });
+    std::thread control([&]() {
+        for (int i = 0; i < controls; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            send_control(TimedMessage{Clock::now(), true});
+        }
+    });
+
+    std::vector<double> latencies;
+    long long sink = 0;
+    while (static_cast<int>(latencies.size()) < controls) {
+        TimedMessage message = recv();
+        if (message.control) {
+            latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - message.sent).count());
+        }
+        // Имитация обработки
+        for (int k = 0; k < 500; k++) sink += k ^ latencies.size();
+    }
+
+    stop = true;
+    control.join();
+    close();
+    bulk.join();
+    if (sink == -1) std::cerr << "Unexpected result" << std::endl;
+
+    std::sort(latencies.begin(), latencies.end());
+    return latencies;
+}
+
+void BenchPriority() {
+    const int controls = 300;
+    const int capacity = 1024;
+
+    std::cout << "\n=== Control-message latency under saturation (us) ===\n";
+    std::cout << std::setw(25) << "Channel"
+              << std::setw(12) << "p50"
+              << std::setw(12) << "p99"
+              << std::setw(12) << "max"
+              << std::endl;
+
+    auto row = [](const std::string& name, const std::vector<double>& latencies) {
+        std::cout << std::setw(25) << name
+                  << std::setw(12) << static_cast<long long>(latencies[latencies.size() / 2])
+                  << std::setw(12) << static_cast<long long>(latencies[latencies.size() * 99 / 100])
+                  << std::setw(12) << static_cast<long long>(latencies.back())
+                  << std::endl;
+    };
+
+    {
+        BufferedChannel<TimedMessage> fifo(capacity);
+        row("BufferedChannel (FIFO)", MeasureControlLatency(
+            [&](TimedMessage m) { fifo.SendNoThrow(m); },
+            [&](TimedMessage m) { fifo.SendNoThrow(m); },
+            [&]() { return fifo.Recv().first; },
+            [&]() { fifo.Close(); },
+            controls));
+    }
+    for (int aging : {0, 64}) {
+        PriorityChannel<TimedMessage> prio({16, capacity}, aging);
+        row("PriorityChannel aging " + std::to_string(aging), MeasureControlLatency(
+            [&](TimedMessage m) { try { prio.Send(m, 1); } catch (const std::runtime_error&) {} },
+            [&](TimedMessage m) { prio.Send(m, 0); },
+            [&]() { return prio.Recv().first; },
+            [&]() { prio.Close(); },
+            controls));
+    }
+}
+
+// Строки размером от 16 Б до 16 КБ (равномерно по логарифму)
+static std::vector<std::string> MakeVariablePayloads(int count) {
+    std::vector<std::string> payloads;
+    uint32_t state = 12345;
+    for (int i = 0; i < count; i++) {
+        state = state * 1664525u + 1013904223u;
+        std::size_t bytes = std::size_t(16) << (state >> 16) % 11;
+        payloads.emplace_back(bytes, 'x');
+    }
+    return payloads;
+}
+
+// Пиковый объем данных в канале и скорость; получатель медленнее отправителя
+template<class Send, class Recv, class Close>
+std::pair<std::size_t, double> MeasurePeakBytes(const std::vector<std::string>& payloads,
+                                                Send send, Recv recv, Close close) {
+    std::atomic<long long> in_flight(0);
+    std::atomic<long long> peak(0);
+
+    auto start = Clock::now();
+    std::thread producer([&]() {
+        for (const auto& payload : payloads) {
+            long long now = in_flight += static_cast<long long>(payload.capacity());
+            long long seen = peak;
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+            send(payload);
+        }
+        close();
+    });
+
+    long long sink = 0;
+    while (true) {
+        auto [value, ok] = recv();
+        if (!ok) break;
+        in_flight -= static_cast<long long>(value.capacity());
+        for (std::size_t k = 0; k < value.size(); k += 64) sink += value[k];
+    }
+    producer.join();
+    if (sink == -1) std::cerr << "Unexpected result" << std::endl;
+    return {static_cast<std::size_t>(peak.load()), payloads.size() / SecondsSince(start)};
+}
+
+void BenchByteBudget() {
+    const int messages = 50000;
+    const std::size_t budget = 1 << 20;
+    auto payloads = MakeVariablePayloads(messages);
+
+    std::cout << "\n=== Item-count vs byte-budget capacity (16 B..16 KB strings) ===\n";
+    std::cout << std::setw(30) << "Channel"
+              << std::setw(18) << "Peak KB"
+              << std::setw(18) << "Messages/sec"
+              << std::endl;
+
+    for (int capacity : {16, 256}) {
+        BufferedChannel<std::string> channel(capacity);
+        auto [peak, rate] = MeasurePeakBytes(payloads,
+            [&](const std::string& s) { channel.Send(s); },
+            [&]() { return channel.Recv(); },
+            [&]() { channel.Close(); });
+        std::cout << std::setw(30) << "BufferedChannel(" + std::to_string(capacity) + ")"
+                  << std::setw(18) << peak / 1024
+                  << std::setw(18) << static_cast<long long>(rate) << std::endl;
+    }
+    {
+        ByteBudgetChannel<std::string> channel(budget);
+        auto [peak, rate] = MeasurePeakBytes(payloads,
+            [&](const std::string& s) { channel.Send(s); },
+            [&]() { return channel.Recv(); },
+            [&]() { channel.Close(); });
+        std::cout << std::setw(30) << "ByteBudgetChannel(1 MB)"
+                  << std::setw(18) << peak / 1024
+                  << std::setw(18) << static_cast<long long>(rate) << std::endl;
+        std::cout << "channel peak by metrics: " << channel.Metrics().peak_bytes / 1024 << " KB" << std::endl;
+    }
+
+    // Справедливость: крупные отправки на фоне потока мелких
+    ByteBudgetChannel<std::string> channel(budget);
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> small;
+    for (int t = 0; t < 4; t++) {
+        small.emplace_back([&]() {
+            std::string message(64, 's');
+            while (!stop) {
+                try { channel.Send(message); } catch (const std::runtime_error&) { break; }
+            }
+        });
+    }
+    std::thread consumer([&]() {
+        while (channel.Recv().second) {}
+    });
+    std::vector<double> waits;
+    for (int i = 0; i < 20; i++) {
+        std::string large(512 * 1024, 'L');
+        auto start = Clock::now();
+        channel.Send(std::move(large));
+        waits.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    stop = true;
+    auto metrics = channel.Metrics();
+    channel.Close();
+    for (auto& thread : small) thread.join();
+    consumer.join();
+    std::sort(waits.begin(), waits.end());
+    std::cout << "512 KB sends among 4 small-message senders: median wait "
+              << waits[waits.size() / 2] << " ms, max " << waits.back() << " ms, "
+              << metrics.blocked_sends << " blocked sends, peak "
+              << metrics.peak_bytes / 1024 << " KB" << std::endl;
+}
+
+// 64 KB сообщения: новый вектор на каждое против буферов из пула
+struct ZeroCopyResult {
+    double rate;
+    double allocs_per_message;
+};
+
+const std::size_t kLargeMessage = 64 * 1024;
+
+static ZeroCopyResult MeasureVectorMessages(int capacity, int messages) {
+    BufferedChannel<std::vector<char>> channel(capacity);
+    long long allocs_before = g_allocations.load();
+    auto start = Clock::now();
+
+    std::thread producer([&]() {
+        for (int i = 0; i < messages; i++) {
+            std::vector<char> message(kLargeMessage, static_cast<char>(i));
+            channel.Send(std::move(message));
+        }
+        channel.Close();
+    });
+
+    long long sink = 0;
+    std::vector<char> message;
+    while (channel.RecvInto(message)) {
+        sink += message[0] + message[kLargeMessage - 1];
+    }
+    producer.join();
+    double seconds = SecondsSince(start);
+    if (sink == -1) std::cerr << "Unexpected result" << std::endl;
+    return {messages / seconds,
+            static_cast<double>(g_allocations.load() - allocs_before) / messages};
+}
+
+static ZeroCopyResult MeasurePooledMessages(int capacity, int messages) {
+    using Block = std::array<char, kLargeMessage>;
+    // Буферов больше, чем мест в канале: пока канал полон, получатель
+    // еще держит один, а отправитель заполняет следующий
+    BufferPool<Block> pool(capacity + 2, []() { return Block(); });
+    BufferedChannel<BufferPool<Block>::Lease> channel(capacity);
+    long long allocs_before = g_allocations.load();
+    auto start = Clock::now();
+
+    std::thread producer([&]() {
+        for (int i = 0; i < messages; i++) {
+            auto lease = pool.Acquire();
+            std::fill(lease->begin(), lease->end(), static_cast<char>(i));
+            channel.Emplace(std::move(lease));
+        }
+        channel.Close();
+    });
+
+    long long sink = 0;
+    BufferPool<Block>::Lease lease;
+    while (channel.RecvInto(lease)) {
+        sink += (*lease)[0] + (*lease)[kLargeMessage - 1];
+        lease.Release();
+    }
+    producer.join();
+    double seconds = SecondsSince(start);
+    if (sink == -1) std::cerr << "Unexpected result" << std::endl;
+    return {messages / seconds,
+            static_cast<double>(g_allocations.load() - allocs_before) / messages};
+}
+
+void BenchZeroCopy() {
+    const int messages = 20000;
+
+    std::cout << "\n=== 64 KB messages: per-message vector vs pooled buffers ===\n";
+    std::cout << std::setw(12) << "Capacity"
+              << std::setw(20) << "Vector msg/sec"
+              << std::setw(16) << "Allocs/msg"
+              << std::setw(20) << "Pool msg/sec"
+              << std::setw(16) << "Allocs/msg"
+              << std::endl;
+
+    for (int capacity : {4, 64}) {
+        auto vec = MeasureVectorMessages(capacity, messages);
+        auto pooled = MeasurePooledMessages(capacity, messages);
+        std::cout << std::setw(12) << capacity
+                  << std::setw(20) << static_cast<long long>(vec.rate)
+                  << std::setw(16) << std::fixed << std::setprecision(3) << vec.allocs_per_message
+                  << std::setw(20) << static_cast<long long>(pooled.rate)
+                  << std::setw(16) << pooled.allocs_per_message
+                  << std::defaultfloat << std::endl;
+    }
+}
+
+// Поровну отправителей и получателей; у ShardedChannel у каждого получателя своя полоса
+static double MeasureSharded(int threads, int capacity, int messages, bool keyed, bool steal,
+                             uint64_t* steals) {
+    ShardedChannel<int> channel(threads, std::max(1, capacity / threads), steal);
+    std::atomic<long long> received(0);
+    auto start = Clock::now();
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < threads; c++) {
+        consumers.emplace_back([&, c]() {
+            long long count = 0;
+            int value;
+            while (channel.RecvInto(c, value)) count++;
+            received += count;
+        });
+    }
+    std::vector<std::thread> producers;
+    for (int p = 0; p < threads; p++) {
+        int begin = static_cast<int>(1LL * messages * p / threads);
+        int end   = static_cast<int>(1LL * messages * (p + 1) / threads);
+        producers.emplace_back([&channel, begin, end, keyed]() {
+            for (int i = begin; i < end; i++) {
+                if (keyed) {
+                    channel.SendKeyed(i % 1024, i);
+                } else {
+                    channel.Send(i);
+                }
+            }
+        });
+    }
+    for (auto& producer : producers) producer.join();
+    channel.Close();
+    for (auto& consumer : consumers) consumer.join();
+
+    double seconds = SecondsSince(start);
+    if (received != messages) {
+        std::cerr << "Lost messages" << std::endl;
+    }
+    *steals = channel.Steals();
+    return messages / seconds;
+}
+
+void BenchSharded() {
+    const int messages = 1000000;
+    const int capacity = 1024;
+    int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    std::cout << "\n=== Single-lock vs sharded channel (N producers, N consumers, "
+              << cores << " cores) ===\n";
+    std::cout << std::setw(8) << "N"
+              << std::setw(22) << "BufferedChannel"
+              << std::setw(22) << "Sharded round-robin"
+              << std::setw(18) << "Sharded keyed"
+              << std::setw(20) << "Keyed, no steal"
+              << std::setw(14) << "Steals"
+              << std::endl;
+
+    // До числа ядер; на маленькой машине хотя бы до 4, чтобы было видно тренд
+    for (int threads = 1; threads <= std::max(cores, 4); threads *= 2) {
+        uint64_t steals = 0;
+        uint64_t unused = 0;
+        double single = MeasureContention<BufferedChannel<int>>(threads, threads, capacity, messages);
+        double round_robin = MeasureSharded(threads, capacity, messages, false, true, &steals);
+        double keyed = MeasureSharded(threads, capacity, messages, true, true, &unused);
+        double pinned = MeasureSharded(threads, capacity, messages, true, false, &unused);
+        std::cout << std::setw(8) << threads
+                  << std::setw(22) << static_cast<long long>(single)
+                  << std::setw(22) << static_cast<long long>(round_robin)
+                  << std::setw(18) << static_cast<long long>(keyed)
+                  << std::setw(20) << static_cast<long long>(pinned)
+                  << std::setw(14) << steals
+                  << (threads > cores ? "  (oversubscribed)" : "")
+                  << std::endl;
+    }
+}
+
+// Получатель в цикле epoll: по событию разбирает канал через TryRecv до kEmpty.
+// Для сравнения - "наивный" вариант с записью в pipe на каждое сообщение
+struct EpollResult {
+    double rate;
+    double wakeups_per_message;
+};
+
+static EpollResult MeasureEpollChannel(int capacity, int messages) {
+    BufferedChannel<int> channel(capacity);
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, channel.ReadableFd(), &event);
+    auto start = Clock::now();
+
+    std::thread producer([&]() {
+        for (int i = 0; i < messages; i++) channel.Send(i);
+        channel.Close();
+    });
+
+    long long wakeups = 0;
+    long long received = 0;
+    bool closed = false;
+    while (!closed) {
+        epoll_event ready;
+        if (epoll_wait(epoll_fd, &ready, 1, -1) <= 0) continue;
+        wakeups++;
+        int value;
+        while (true) {
+            ChannelStatus status = channel.TryRecv(value);
+            if (status == ChannelStatus::kOk) {
+                received++;
+                continue;
+            }
+            closed = status == ChannelStatus::kClosed;
+            break;
+        }
+    }
+    producer.join();
+    double seconds = SecondsSince(start);
+    close(epoll_fd);
+    if (received != messages) std::cerr << "Lost messages" << std::endl;
+    return {messages / seconds, static_cast<double>(wakeups) / messages};
+}
+
+static EpollResult MeasureEpollPipe(int messages) {
+    int fds[2];
+    if (pipe(fds) != 0) return {0, 0};
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fds[0], &event);
+    auto start = Clock::now();
+
+    std::thread producer([&]() {
+        for (int i = 0; i < messages; i++) WriteFull(fds[1], &i, sizeof(i));
+        close(fds[1]);
+    });
+
+    long long wakeups = 0;
+    long long received = 0;
+    std::array<int, 256> batch;
+    while (true) {
+        epoll_event ready;
+        if (epoll_wait(epoll_fd, &ready, 1, -1) <= 0) continue;
+        wakeups++;
+        ssize_t n = read(fds[0], batch.data(), sizeof(batch));
+        if (n <= 0) break;
+        received += n / static_cast<ssize_t>(sizeof(int));
+        if (n % sizeof(int) != 0) {
+            ReadFull(fds[0], reinterpret_cast<char*>(batch.data()) + n,
+                     sizeof(int) - n % sizeof(int));
+            received++;
+        }
+    }
+    producer.join();
+    double seconds = SecondsSince(start);
+    close(fds[0]);
+    close(epoll_fd);
+    if (received != messages) std::cerr << "Lost messages" << std::endl;
+    return {messages / seconds, static_cast<double>(wakeups) / messages};
+}
+
+void BenchEventFd() {
+    const int messages = 500000;
+
+    std::cout << "\n=== Channel in an epoll loop (eventfd readiness) ===\n";
+    std::cout << std::setw(26) << "Source"
+              << std::setw(18) << "Messages/sec"
+              << std::setw(22) << "Wakeups/1000 msg"
+              << std::endl;
+
+    for (int capacity : {16, 1024}) {
+        auto result = MeasureEpollChannel(capacity, messages);
+        std::cout << std::setw(26) << "BufferedChannel(" + std::to_string(capacity) + ")"
+                  << std::setw(18) << static_cast<long long>(result.rate)
+                  << std::setw(22) << std::fixed << std::setprecision(1)
+                  << result.wakeups_per_message * 1000 << std::defaultfloat << std::endl;
+    }
+    auto result = MeasureEpollPipe(messages);
+    std::cout << std::setw(26) << "pipe, write per message"
+              << std::setw(18) << static_cast<long long>(result.rate)
+              << std::setw(22) << std::fixed << std::setprecision(1)
+              << result.wakeups_per_message * 1000 << std::defaultfloat << std::endl;
+}
+
+// 1M таймеров: вставка и отмена в колесе против упорядоченного дерева
+// (std::multimap, O(log n)), затем опоздание доставки в общий канал.
+// After/Ticker меряются отдельно: у них на каждый таймер свой канал
+void BenchTimers() {
+    const int timers = 1000000;
+    // Сроки 0.5..1.5 с: вставка успевает закончиться до первых срабатываний
+    const auto spread = std::chrono::seconds(1);
+
+    std::cout << "\n=== Timer wheel, " << timers << " active timers ===\n";
+
+    auto row = [](const std::string& name, double insert_ns, double cancel_ns, double allocs) {
+        std::cout << std::setw(28) << name
+                  << "  insert " << std::setw(7) << static_cast<long long>(insert_ns) << " ns"
+                  << "  cancel " << std::setw(7) << static_cast<long long>(cancel_ns) << " ns"
+                  << "  allocs/timer " << std::fixed << std::setprecision(2) << allocs
+                  << std::defaultfloat << std::endl;
+    };
+
+    std::vector<std::chrono::nanoseconds> delays(timers);
+    uint64_t state = 88172645463325252ULL;
+    for (auto& delay : delays) {
+        state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+        delay = std::chrono::nanoseconds(
+            500000000 + static_cast<int64_t>(state % static_cast<uint64_t>(
+                std::chrono::nanoseconds(spread).count())));
+    }
+
+    {
+        std::multimap<Clock::time_point, int> tree;
+        std::vector<std::multimap<Clock::time_point, int>::iterator> handles(timers);
+        auto now = Clock::now();
+        long long allocs_before = g_allocations.load();
+        double insert_ns = NanosPerOp(timers, [&](int i) {
+            handles[i] = tree.emplace(now + delays[i], i);
+        });
+        double allocs = static_cast<double>(g_allocations.load() - allocs_before) / timers;
+        double cancel_ns = NanosPerOp(timers / 2, [&](int i) {
+            tree.erase(handles[2 * i]);
+        });
+        row("std::multimap", insert_ns, cancel_ns, allocs);
+    }
+
+    TimerService service;
+    auto sink = std::make_shared<TimerService::EventChannel>(timers);
+    std::vector<TimerId> ids(timers);
+    long long allocs_before = g_allocations.load();
+    double insert_ns = NanosPerOp(timers, [&](int i) {
+        ids[i] = service.AfterInto(delays[i], sink, static_cast<uint64_t>(i));
+    });
+    double allocs = static_cast<double>(g_allocations.load() - allocs_before) / timers;
+    std::size_t cancelled = 0;
+    double cancel_ns = NanosPerOp(timers / 2, [&](int i) {
+        cancelled += service.Cancel(ids[2 * i]);
+    });
+    row("AfterInto (1 ms tick)", insert_ns, cancel_ns, allocs);
+
+    // Получатель разбирает события порциями и меряет опоздание
+    std::size_t expected = timers - cancelled;
+    std::vector<double> lateness_us;
+    lateness_us.reserve(expected);
+    std::vector<TimerEvent> events;
+    std::size_t batches = 0;
+    auto start = Clock::now();
+    while (lateness_us.size() < expected) {
+        std::array<TimerEvent, 1024> chunk;
+        std::size_t received = sink->RecvMany(chunk);
+        auto now = Clock::now();
+        batches++;
+        for (std::size_t i = 0; i < received; i++) {
+            lateness_us.push_back(std::chrono::duration<double, std::micro>(now - chunk[i].deadline).count());
+        }
+    }
+    double seconds = SecondsSince(start);
+    std::sort(lateness_us.begin(), lateness_us.end());
+    auto percentile = [&](double p) {
+        return lateness_us[static_cast<std::size_t>(p * (lateness_us.size() - 1))];
+    };
+    std::cout << "delivered " << lateness_us.size() << " expirations in " << std::fixed
+              << std::setprecision(2) << seconds << " s, " << batches << " receive batches, "
+              << service.Dropped() << " dropped\n"
+              << "lateness us: p50 " << std::setprecision(0) << percentile(0.5)
+              << "  p99 " << percentile(0.99)
+              << "  p99.9 " << percentile(0.999)
+              << "  max " << lateness_us.back()
+              << std::defaultfloat << std::endl;
+
+    // After(d): make_shared и канал на таймер. Оставшиеся получаем по одному
+    // в порядке задержек - здесь важна цена вставки, а не опоздание
+    {
+        std::vector<TimerService::Timer> after(timers);
+        allocs_before = g_allocations.load();
+        insert_ns = NanosPerOp(timers, [&](int i) {
+            after[i] = service.After(delays[i]);
+        });
+        allocs = static_cast<double>(g_allocations.load() - allocs_before) / timers;
+        cancel_ns = NanosPerOp(timers / 2, [&](int i) {
+            service.Cancel(after[2 * i].id);
+        });
+        row("After(d)", insert_ns, cancel_ns, allocs);
+
+        std::vector<int> order;
+        order.reserve(timers / 2);
+        for (int i = 1; i < timers; i += 2) order.push_back(i);
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return delays[a] < delays[b]; });
+        std::size_t received = 0;
+        start = Clock::now();
+        for (int i : order) {
+            received += after[i].channel->Recv().second;
+        }
+        std::cout << "received " << received << " of " << order.size()
+                  << " uncancelled After channels in " << std::fixed << std::setprecision(2)
+                  << SecondsSince(start) << " s" << std::defaultfloat << std::endl;
+    }
+
+    // Ticker(period): периоды 0.5..1.5 с, каналы никто не читает -
+    // лишние тики пропадают, колесо все равно перекладывает каждый таймер
+    {
+        std::vector<TimerService::Timer> tickers(timers);
+        allocs_before = g_allocations.load();
+        insert_ns = NanosPerOp(timers, [&](int i) {
+            tickers[i] = service.Ticker(delays[i]);
+        });
+        allocs = static_cast<double>(g_allocations.load() - allocs_before) / timers;
+        uint64_t fired_before = service.Fired();
+        start = Clock::now();
+        std::this_thread::sleep_for(std::chrono::seconds(2));
+        double ticks_per_second = static_cast<double>(service.Fired() - fired_before) / SecondsSince(start);
+        cancel_ns = NanosPerOp(timers, [&](int i) {
+            service.Cancel(tickers[i].id);
+        });
+        row("Ticker(period)", insert_ns, cancel_ns, allocs);
+        std::cout << "tickers fired " << static_cast<long long>(ticks_per_second)
+                  << " ticks/s over 2 s" << std::endl;
+    }
+}
+
+// Запрос-ответ: буфер емкости 1 против передачи из рук в руки без буфера
+void BenchRendezvous() {
+    const int rounds = 100000;
+
+    std::cout << "\n=== Rendezvous: capacity 1 vs unbuffered direct handoff (ping-pong) ===\n";
+    PrintPingPongHeader("Channel");
+
+    MeasureWaitStrategy<BufferedChannel<int>>("Buffered(1) condvar", rounds, {});
+    MeasureWaitStrategy<BufferedChannel<int, SpinFutexWaiter>>("Buffered(1) spin+futex", rounds, {});
+    for (int spin : {0, 500}) {
+        SpinFutexOptions options;
+        options.spin_iterations = spin;
+        RendezvousChannel<int> ping(options);
+        RendezvousChannel<int> pong(options);
+        MeasurePingPong("Rendezvous spin " + std::to_string(spin), rounds, ping, pong);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string only = argc > 1 ? argv[1] : "";
+
+    if (only.empty() || only == "spsc") BenchSpsc();
+    if (only.empty() || only == "mpmc") BenchMpmc();
+    if (only.empty() || only == "status") BenchStatus();
+    if (only.empty() || only == "select") BenchSelect();
+    if (only.empty() || only == "wait") BenchWait();
+    if (only.empty() || only == "stats") BenchStats();
+    if (only.empty() || only == "coro") BenchCoroutines();
+    if (only.empty() || only == "shm") BenchShm();
+    if (only.empty() || only == "broadcast") BenchBroadcast();
+    if (only.empty() || only == "priority") BenchPriority();
+    if (only.empty() || only == "bytes") BenchByteBudget();
+    if (only.empty() || only == "zerocopy") BenchZeroCopy();
+    if (only.empty() || only == "sharded") BenchSharded();
+    if (only.empty() || only == "eventfd") BenchEventFd();
+    if (only.empty() || only == "timers") BenchTimers();
+    if (only.empty() || only == "rendezvous") BenchRendezvous();
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "buhhered_channel.h"
+#include "coro_executor.h"
+
+// Потоки и корутины на одном BufferedChannel: никто не должен остаться
+// ждать, пока в буфере лежит элемент (или есть место), и корутина получает
+// "закрыт" только после того, как буфер разобран. Паузы дают потоку
+// заблокироваться, а корутине - приостановиться раньше следующего шага.
+// Код возврата 1, если хоть один сценарий не прошел.
+//
+//   g++ -std=c++20 -O2 -pthread channel_coro_check.cpp -o channel_coro_check
+
+using namespace std::chrono_literals;
+
+static bool Check(const std::string& name, bool ok, const std::string& reason = "") {
+    std::cout << (ok ? "ok    " : "FAIL  ") << name;
+    if (!ok && !reason.empty()) {
+        std::cout << ": " << reason;
+    }
+    std::cout << std::endl;
+    return ok;
+}
+
+// Результат корутины-получателя; -1 - еще не возобновлена
+struct RecvResult {
+    std::atomic<int> value{-1};
+    std::atomic<bool> ok{false};
+};
+
+Task CoroRecv(BufferedChannel<int>& channel, RecvResult& result) {
+    auto [value, ok] = co_await channel.AsyncRecv();
+    result.ok.store(ok);
+    result.value.store(ok ? value : 0);
+}
+
+Task CoroSend(BufferedChannel<int>& channel, int value, std::atomic<bool>& done) {
+    co_await channel.AsyncSend(value);
+    done.store(true);
+}
+
+template<class Pred>
+static bool WaitFor(Pred pred, std::chrono::milliseconds timeout = 2000ms) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+// Поток T ждет в Recv раньше корутины C; порция из двух элементов
+// достается обоим: первый - T, второй - C
+static bool CheckBatchToThreadAndCoroutine() {
+    BufferedChannel<int> channel(4);
+    Executor executor(1);
+    std::atomic<int> thread_value{-1};
+    std::thread thread([&]() { thread_value.store(channel.Recv().first); });
+    std::this_thread::sleep_for(50ms);
+
+    RecvResult coro;
+    executor.Spawn(CoroRecv(channel, coro));
+    std::this_thread::sleep_for(50ms);
+
+    std::vector<int> batch = {1, 2};
+    channel.SendMany(batch.begin(), batch.end());
+    thread.join();
+    bool ok = WaitFor([&]() { return coro.value.load() != -1; });
+    channel.Close();  // при ошибке иначе корутина так и не завершится
+    executor.WaitIdle();
+    return Check("SendMany to older thread and coroutine",
+                 ok && thread_value.load() == 1 && coro.ok.load() && coro.value.load() == 2,
+                 ok ? "wrong values" : "coroutine left suspended with an item in the buffer");
+}
+
+// То же, но канал закрывают сразу после порции: корутина получает
+// элемент из буфера, а не "закрыт"
+static bool CheckCloseAfterBatch() {
+    BufferedChannel<int> channel(4);
+    Executor executor(1);
+    std::thread thread([&]() { channel.Recv(); });
+    std::this_thread::sleep_for(50ms);
+
+    RecvResult coro;
+    executor.Spawn(CoroRecv(channel, coro));
+    std::this_thread::sleep_for(50ms);
+
+    std::vector<int> batch = {1, 2};
+    channel.SendMany(batch.begin(), batch.end());
+    channel.Close();
+    thread.join();
+    bool ok = WaitFor([&]() { return coro.value.load() != -1; });
+    executor.WaitIdle();
+    int left = 0;
+    bool drained = channel.TryRecv(left) == ChannelStatus::kClosed;
+    return Check("Close with items left for a coroutine",
+                 ok && coro.ok.load() && coro.value.load() == 2 && drained,
+                 "coroutine got closed while the buffer still had an item");
+}
+
+// Старший поток уходит из RecvFor по таймауту - следующий элемент
+// достается ждущей за ним корутине
+static bool CheckThreadTimeout() {
+    BufferedChannel<int> channel(4);
+    Executor executor(1);
+    std::thread thread([&]() {
+        int out;
+        channel.RecvFor(out, 100ms);
+    });
+    std::this_thread::sleep_for(20ms);
+
+    RecvResult coro;
+    executor.Spawn(CoroRecv(channel, coro));
+    thread.join();
+
+    channel.TrySend(7);
+    bool ok = WaitFor([&]() { return coro.value.load() != -1; });
+    channel.Close();  // при ошибке иначе корутина так и не завершится
+    executor.WaitIdle();
+    return Check("older thread times out, coroutine receives",
+                 ok && coro.value.load() == 7, "coroutine left suspended");
+}
+
+// Сторона отправителей: канал полон, поток TS ждет в Send раньше корутины CS.
+// RecvMany освобождает два места - их получают оба
+static bool CheckSendersAfterRecvMany() {
+    BufferedChannel<int> channel(2);
+    Executor executor(1);
+    channel.Send(1);
+    channel.Send(2);
+    std::thread thread([&]() { channel.Send(3); });
+    std::this_thread::sleep_for(50ms);
+
+    std::atomic<bool> sent(false);
+    executor.Spawn(CoroSend(channel, 4, sent));
+    std::this_thread::sleep_for(50ms);
+
+    int out[2];
+    std::size_t received = channel.RecvMany(out);
+    thread.join();
+    bool ok = WaitFor([&]() { return sent.load(); });
+    if (!ok) {
+        int drop;
+        channel.TryRecv(drop);
+    }
+    executor.WaitIdle();
+
+    std::vector<int> rest;
+    channel.DrainAll(rest);
+    return Check("RecvMany frees room for older thread and coroutine",
+                 ok && received == 2 && rest == std::vector<int>{3, 4},
+                 ok ? "wrong order" : "coroutine sender left suspended with room in the buffer");
+}
+
+// TrySendMany (порция таймеров TimerService): кладет только то, что
+// помещается, будит ждущую корутину и после Close ничего не принимает
+static bool CheckTrySendManyPartial() {
+    BufferedChannel<int> channel(2);
+    Executor executor(1);
+    RecvResult coro;
+    executor.Spawn(CoroRecv(channel, coro));
+    std::this_thread::sleep_for(50ms);
+
+    std::vector<int> batch = {1, 2, 3};
+    std::size_t sent = channel.TrySendMany(batch.begin(), batch.end());
+    bool ok = WaitFor([&]() { return coro.value.load() != -1; });
+    channel.Close();
+    executor.WaitIdle();
+
+    std::vector<int> rest;
+    channel.DrainAll(rest);
+    std::size_t after_close = channel.TrySendMany(batch.begin(), batch.end());
+    return Check("TrySendMany partial batch wakes coroutine",
+                 ok && sent == 2 && coro.value.load() == 1 && rest == std::vector<int>{2} && after_close == 0,
+                 ok ? "wrong count or values" : "coroutine left suspended with an item in the buffer");
+}
+
+int main() {
+    bool ok = CheckBatchToThreadAndCoroutine();
+    ok = CheckCloseAfterBatch() && ok;
+    ok = CheckThreadTimeout() && ok;
+    ok = CheckSendersAfterRecvMany() && ok;
+    ok = CheckTrySendManyPartial() && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+#ifndef CHANNEL_EVENTFD_H_
+#define CHANNEL_EVENTFD_H_
+
+#include <cerrno>
+#include <cstdint>
+#include <system_error>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+// Готовность канала в виде двух eventfd для epoll/poll:
+// readable - есть элементы (или канал закрыт), writable - есть место (или закрыт).
+//
+// Объединение пробуждений: fd взводится только на переходе "не готов -> готов",
+// если он еще не взведен, и сбрасывается лениво - когда TryRecv/TrySend
+// вернули kEmpty/kFull. Цикл, который по событию разбирает канал до kEmpty,
+// платит один write и один read на порцию, а не системный вызов на сообщение.
+// Лишнее срабатывание возможно и безвредно: TryRecv просто вернет kEmpty.
+//
+// Все методы вызываются под мьютексом канала.
+class EventFdReadiness {
+public:
+    EventFdReadiness(bool readable, bool writable) : readable_fd_(MakeEventFd()) {
+        try {
+            writable_fd_ = MakeEventFd();
+        } catch (...) {
+            close(readable_fd_);
+            throw;
+        }
+        Update(readable, writable);
+    }
+
+    ~EventFdReadiness() {
+        close(readable_fd_);
+        close(writable_fd_);
+    }
+
+    EventFdReadiness(const EventFdReadiness&) = delete;
+    EventFdReadiness& operator=(const EventFdReadiness&) = delete;
+
+    int ReadableFd() const { return readable_fd_; }
+    int WritableFd() const { return writable_fd_; }
+
+    // Взвести то, что стало готово; сброс - только через Clear*
+    void Update(bool readable, bool writable) {
+        if (readable && !readable_set_) {
+            Signal(readable_fd_);
+            readable_set_ = true;
+        }
+        if (writable && !writable_set_) {
+            Signal(writable_fd_);
+            writable_set_ = true;
+        }
+    }
+
+    void ClearReadable() {
+        if (readable_set_) {
+            Drain(readable_fd_);
+            readable_set_ = false;
+        }
+    }
+
+    void ClearWritable() {
+        if (writable_set_) {
+            Drain(writable_fd_);
+            writable_set_ = false;
+        }
+    }
+
+private:
+    static int MakeEventFd() {
+        int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "eventfd");
+        }
+        return fd;
+    }
+
+    static void Signal(int fd) {
+        uint64_t one = 1;
+        while (write(fd, &one, sizeof(one)) < 0 && errno == EINTR) {}
+    }
+
+    // Счетчик eventfd обнуляется одним чтением
+    static void Drain(int fd) {
+        uint64_t value;
+        while (read(fd, &value, sizeof(value)) < 0 && errno == EINTR) {}
+    }
+
+    const int readable_fd_;
+    int writable_fd_ = -1;
+    bool readable_set_ = false;
+    bool writable_set_ = false;
+};
+
+#endif // CHANNEL_EVENTFD_H_
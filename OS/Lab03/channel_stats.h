@@ -0,0 +1,176 @@
+#ifndef CHANNEL_STATS_H_
+#define CHANNEL_STATS_H_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Инструментация каналов включается при сборке с -DCHANNEL_STATS.
+// Без макроса ChannelStats - пустой класс с пустыми inline-методами:
+// канал не хранит ни байта и не вызывает часы.
+// Макрос должен быть одинаковым во всех единицах трансляции программы.
+
+// Гистограмма заполненности: [0] - пусто, [i] - заполнено на ((i-1)/8, i/8] емкости
+constexpr std::size_t kOccupancyBuckets = 9;
+// Заполненность записывается на каждой kOccupancySamplePeriod-й операции
+constexpr uint64_t kOccupancySamplePeriod = 64;
+
+struct ChannelStatsSnapshot {
+    bool enabled = false;
+    std::size_t capacity = 0;
+    std::size_t size = 0;
+    std::size_t high_water = 0;
+    uint64_t sends = 0;
+    uint64_t recvs = 0;
+    // Сколько раз и как долго отправители ждали места, а получатели - данных
+    uint64_t send_waits = 0;
+    uint64_t recv_waits = 0;
+    std::chrono::nanoseconds send_blocked{0};
+    std::chrono::nanoseconds recv_blocked{0};
+    std::array<uint64_t, kOccupancyBuckets> occupancy{};
+    std::chrono::nanoseconds uptime{0};
+
+    // Разница со снимком, сделанным раньше: счетчики и время за интервал.
+    // high_water и size остаются текущими
+    ChannelStatsSnapshot Since(const ChannelStatsSnapshot& earlier) const {
+        ChannelStatsSnapshot delta = *this;
+        delta.sends -= earlier.sends;
+        delta.recvs -= earlier.recvs;
+        delta.send_waits -= earlier.send_waits;
+        delta.recv_waits -= earlier.recv_waits;
+        delta.send_blocked -= earlier.send_blocked;
+        delta.recv_blocked -= earlier.recv_blocked;
+        for (std::size_t i = 0; i < kOccupancyBuckets; ++i) {
+            delta.occupancy[i] -= earlier.occupancy[i];
+        }
+        delta.uptime -= earlier.uptime;
+        return delta;
+    }
+
+    double SendsPerSecond() const {
+        return uptime.count() > 0 ? sends * 1e9 / uptime.count() : 0.0;
+    }
+};
+
+// Одна строка для периодического вывода
+inline std::ostream& operator<<(std::ostream& out, const ChannelStatsSnapshot& stats) {
+    if (!stats.enabled) {
+        return out << "stats disabled (build with -DCHANNEL_STATS)";
+    }
+    out << "size " << stats.size << "/" << stats.capacity
+        << " hwm " << stats.high_water
+        << " sends " << stats.sends
+        << " recvs " << stats.recvs
+        << " msg/s " << static_cast<long long>(stats.SendsPerSecond())
+        << " send blocked " << stats.send_waits << "x "
+        << std::chrono::duration_cast<std::chrono::microseconds>(stats.send_blocked).count() << "us"
+        << " recv blocked " << stats.recv_waits << "x "
+        << std::chrono::duration_cast<std::chrono::microseconds>(stats.recv_blocked).count() << "us"
+        << " occupancy [";
+    for (std::size_t i = 0; i < kOccupancyBuckets; ++i) {
+        out << (i ? " " : "") << stats.occupancy[i];
+    }
+    return out << "]";
+}
+
+#ifdef CHANNEL_STATS
+
+// Все методы вызываются под мьютексом канала, поэтому счетчики обычные
+class ChannelStats {
+public:
+    using Clock = std::chrono::steady_clock;
+    using WaitStart = Clock::time_point;
+
+    explicit ChannelStats(std::size_t capacity)
+        : capacity_(capacity), created_(Clock::now()) {}
+
+    void OnSend(std::size_t size) {
+        ++sends_;
+        if (size > high_water_) {
+            high_water_ = size;
+        }
+        Sample(size);
+    }
+
+    void OnRecv(std::size_t size) {
+        ++recvs_;
+        Sample(size);
+    }
+
+    WaitStart BeginWait() const { return Clock::now(); }
+
+    void OnSendBlocked(WaitStart start) {
+        ++send_waits_;
+        send_blocked_ += Clock::now() - start;
+    }
+
+    void OnRecvBlocked(WaitStart start) {
+        ++recv_waits_;
+        recv_blocked_ += Clock::now() - start;
+    }
+
+    ChannelStatsSnapshot Snapshot(std::size_t size) const {
+        ChannelStatsSnapshot snapshot;
+        snapshot.enabled = true;
+        snapshot.capacity = capacity_;
+        snapshot.size = size;
+        snapshot.high_water = high_water_;
+        snapshot.sends = sends_;
+        snapshot.recvs = recvs_;
+        snapshot.send_waits = send_waits_;
+        snapshot.recv_waits = recv_waits_;
+        snapshot.send_blocked = std::chrono::duration_cast<std::chrono::nanoseconds>(send_blocked_);
+        snapshot.recv_blocked = std::chrono::duration_cast<std::chrono::nanoseconds>(recv_blocked_);
+        snapshot.occupancy = occupancy_;
+        snapshot.uptime = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - created_);
+        return snapshot;
+    }
+
+private:
+    void Sample(std::size_t size) {
+        if (++operations_ % kOccupancySamplePeriod != 0) {
+            return;
+        }
+        std::size_t bucket = 0;
+        if (size > 0) {
+            bucket = capacity_ > 0 ? (size * 8 + capacity_ - 1) / capacity_ : 8;
+            if (bucket > 8) bucket = 8;
+        }
+        ++occupancy_[bucket];
+    }
+
+    const std::size_t capacity_;
+    const Clock::time_point created_;
+    std::size_t high_water_ = 0;
+    uint64_t sends_ = 0;
+    uint64_t recvs_ = 0;
+    uint64_t send_waits_ = 0;
+    uint64_t recv_waits_ = 0;
+    uint64_t operations_ = 0;
+    Clock::duration send_blocked_{0};
+    Clock::duration recv_blocked_{0};
+    std::array<uint64_t, kOccupancyBuckets> occupancy_{};
+};
+
+#else
+
+class ChannelStats {
+public:
+    struct WaitStart {};
+
+    explicit ChannelStats(std::size_t) {}
+
+    void OnSend(std::size_t) {}
+    void OnRecv(std::size_t) {}
+    WaitStart BeginWait() const { return {}; }
+    void OnSendBlocked(WaitStart) {}
+    void OnRecvBlocked(WaitStart) {}
+
+    ChannelStatsSnapshot Snapshot(std::size_t) const { return {}; }
+};
+
+#endif // CHANNEL_STATS
+
+#endif // CHANNEL_STATS_H_
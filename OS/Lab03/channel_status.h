@@ -0,0 +1,37 @@
+#ifndef CHANNEL_STATUS_H_
+#define CHANNEL_STATUS_H_
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+// Результат неблокирующих и ограниченных по времени операций каналов
+enum class ChannelStatus {
+    kOk,
+    kFull,
+    kEmpty,
+    kClosed,
+    kTimeout,
+};
+
+inline const char* ToString(ChannelStatus status) {
+    switch (status) {
+        case ChannelStatus::kOk:      return "ok";
+        case ChannelStatus::kFull:    return "full";
+        case ChannelStatus::kEmpty:   return "empty";
+        case ChannelStatus::kClosed:  return "closed";
+        case ChannelStatus::kTimeout: return "timeout";
+    }
+    return "unknown";
+}
+
+// Емкость канала проверяется одинаково во всех каналах: 0 и меньше -
+// std::invalid_argument, а не молчаливая емкость 1
+inline std::size_t CheckedCapacity(int size, const char* channel) {
+    if (size <= 0) {
+        throw std::invalid_argument(std::string(channel) + " needs capacity > 0");
+    }
+    return static_cast<std::size_t>(size);
+}
+
+#endif // CHANNEL_STATUS_H_
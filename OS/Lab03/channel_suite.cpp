@@ -0,0 +1,329 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <memory>
+#include <ctime>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <pthread.h>
+#include <sched.h>
+
+#include "alloc_counter.h"
+#include "buhhered_channel.h"
+#include "channel_waiter.h"
+#include "mpmc_channel.h"
+#include "rendezvous_channel.h"
+#include "sharded_channel.h"
+#include "spsc_channel.h"
+
+// Матрица микробенчмарков каналов: вариант канала x топология x емкость x
+// размер сообщения x привязка потоков к ядрам. Результат - JSON в stdout,
+// ход выполнения - в stderr, так что вывод можно сразу сохранять и сравнивать:
+//
+//   ./channel_suite > before.json
+//   ./channel_suite --quick --only=BufferedChannel/mpmc
+//
+// Задержка передачи - от Send до возврата Recv, по отметке времени в самом
+// сообщении. CPU на сообщение - процессорное время всего процесса (включая
+// ожидание с кручением), деленное на число сообщений.
+
+using Clock = std::chrono::steady_clock;
+
+static int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count();
+}
+
+static double ProcessCpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Сообщение ровно Size байт; первые 8 - время отправки
+template<std::size_t Size>
+struct Payload {
+    int64_t sent_ns = 0;
+    char data[Size - sizeof(int64_t)];
+};
+
+template<>
+struct Payload<sizeof(int64_t)> {
+    int64_t sent_ns = 0;
+};
+
+enum class Topology { kSpsc, kMpsc, kSpmc, kMpmc };
+
+static const char* TopologyName(Topology topology) {
+    switch (topology) {
+        case Topology::kSpsc: return "spsc";
+        case Topology::kMpsc: return "mpsc";
+        case Topology::kSpmc: return "spmc";
+        case Topology::kMpmc: return "mpmc";
+    }
+    return "?";
+}
+
+struct RunConfig {
+    Topology topology;
+    int producers;
+    int consumers;
+    int capacity;
+    bool pinned;
+    int messages;
+};
+
+struct RunResult {
+    double seconds = 0;
+    double p50_ns = 0;
+    double p99_ns = 0;
+    double p999_ns = 0;
+    double max_ns = 0;
+    double cpu_ns_per_message = 0;
+    double allocs_per_message = 0;
+    long long received = 0;
+};
+
+// Точки расширения для вариантов канала: как создать и как получать.
+// Новый вариант - перегрузка этих функций и строка в RunVariants
+template<class Channel>
+std::unique_ptr<Channel> MakeChannel(int capacity, int /*consumers*/) {
+    return std::make_unique<Channel>(capacity);
+}
+
+template<class T>
+std::unique_ptr<ShardedChannel<T>> MakeShardedChannel(int capacity, int consumers) {
+    return std::make_unique<ShardedChannel<T>>(consumers, std::max(1, capacity / consumers));
+}
+
+template<class T>
+std::unique_ptr<RendezvousChannel<T>> MakeRendezvousChannel(int /*capacity*/, int /*consumers*/) {
+    return std::make_unique<RendezvousChannel<T>>();
+}
+
+template<class Channel, class T>
+bool RecvInto(Channel& channel, int /*consumer*/, T& out) {
+    auto [value, ok] = channel.Recv();
+    if (ok) out = std::move(value);
+    return ok;
+}
+
+template<class T>
+bool RecvInto(ShardedChannel<T>& channel, int consumer, T& out) {
+    return channel.RecvInto(consumer, out);
+}
+
+static void PinThread(std::thread& thread, int index) {
+    int cpus = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cpus, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+}
+
+static double Percentile(const std::vector<int64_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    return static_cast<double>(sorted[static_cast<std::size_t>(p * (sorted.size() - 1))]);
+}
+
+template<class Channel, class T>
+RunResult RunOnce(Channel& channel, const RunConfig& config) {
+    std::vector<std::vector<int64_t>> latencies(config.consumers);
+    for (auto& samples : latencies) samples.reserve(config.messages / config.consumers + 1);
+
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    int total_threads = config.producers + config.consumers;
+    auto wait_start = [&]() {
+        ready.fetch_add(1);
+        while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+    };
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < config.consumers; c++) {
+        consumers.emplace_back([&, c]() {
+            wait_start();
+            auto& samples = latencies[c];
+            T message;
+            while (RecvInto(channel, c, message)) {
+                samples.push_back(NowNs() - message.sent_ns);
+            }
+        });
+        if (config.pinned) PinThread(consumers.back(), c);
+    }
+    std::vector<std::thread> producers;
+    for (int p = 0; p < config.producers; p++) {
+        int count = static_cast<int>(1LL * config.messages * (p + 1) / config.producers -
+                                     1LL * config.messages * p / config.producers);
+        producers.emplace_back([&, count]() {
+            wait_start();
+            T message{};
+            for (int i = 0; i < count; i++) {
+                message.sent_ns = NowNs();
+                channel.Send(message);
+            }
+        });
+        if (config.pinned) PinThread(producers.back(), config.consumers + p);
+    }
+
+    while (ready.load() != total_threads) std::this_thread::yield();
+    long long allocs_before = g_allocations.load();
+    double cpu_start = ProcessCpuSeconds();
+    auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+
+    for (auto& producer : producers) producer.join();
+    channel.Close();
+    for (auto& consumer : consumers) consumer.join();
+
+    RunResult result;
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.cpu_ns_per_message = (ProcessCpuSeconds() - cpu_start) * 1e9 / config.messages;
+    result.allocs_per_message =
+        static_cast<double>(g_allocations.load() - allocs_before) / config.messages;
+
+    std::vector<int64_t> all;
+    all.reserve(config.messages);
+    for (auto& samples : latencies) all.insert(all.end(), samples.begin(), samples.end());
+    std::sort(all.begin(), all.end());
+    result.received = static_cast<long long>(all.size());
+    result.p50_ns = Percentile(all, 0.5);
+    result.p99_ns = Percentile(all, 0.99);
+    result.p999_ns = Percentile(all, 0.999);
+    result.max_ns = all.empty() ? 0 : static_cast<double>(all.back());
+    return result;
+}
+
+struct Suite {
+    bool quick = false;
+    std::string only;
+    int threads = 4;
+    bool first = true;
+
+    // Сообщений на прогон: около 256 МБ данных, но не меньше 2000 и не больше 200000
+    int MessagesFor(std::size_t payload) const {
+        long long messages = (256LL << 20) / static_cast<long long>(payload);
+        messages = std::clamp(messages, 2000LL, 200000LL);
+        return static_cast<int>(quick ? messages / 10 : messages);
+    }
+
+    template<class Channel, class T, class Make>
+    void Run(const std::string& variant, Topology topology, int capacity, std::size_t payload,
+             bool pinned, Make make) {
+        std::string key = variant + "/" + TopologyName(topology) + "/" + std::to_string(capacity) +
+                          "/" + std::to_string(payload) + (pinned ? "/pinned" : "/unpinned");
+        if (!only.empty() && key.find(only) == std::string::npos) return;
+
+        RunConfig config;
+        config.topology = topology;
+        bool many_producers = topology == Topology::kMpsc || topology == Topology::kMpmc;
+        bool many_consumers = topology == Topology::kSpmc || topology == Topology::kMpmc;
+        config.producers = many_producers ? threads : 1;
+        config.consumers = many_consumers ? threads : 1;
+        config.capacity = capacity;
+        config.pinned = pinned;
+        config.messages = MessagesFor(payload);
+
+        std::cerr << key << " ..." << std::flush;
+        auto channel = make(capacity, config.consumers);
+        RunResult result = RunOnce<Channel, T>(*channel, config);
+        std::cerr << " " << static_cast<long long>(config.messages / result.seconds) << " msg/s"
+                  << std::endl;
+        if (result.received != config.messages) {
+            std::cerr << "Lost messages in " << key << std::endl;
+        }
+
+        std::cout << (first ? "\n" : ",\n") << std::fixed << std::setprecision(1)
+                  << "    {\"variant\": \"" << variant << "\""
+                  << ", \"topology\": \"" << TopologyName(topology) << "\""
+                  << ", \"producers\": " << config.producers
+                  << ", \"consumers\": " << config.consumers
+                  << ", \"capacity\": " << capacity
+                  << ", \"payload_bytes\": " << payload
+                  << ", \"pinned\": " << (pinned ? "true" : "false")
+                  << ", \"messages\": " << config.messages
+                  << ", \"seconds\": " << std::setprecision(4) << result.seconds << std::setprecision(1)
+                  << ", \"msgs_per_sec\": " << config.messages / result.seconds
+                  << ", \"mb_per_sec\": " << config.messages * payload / result.seconds / (1 << 20)
+                  << ", \"latency_ns\": {\"p50\": " << result.p50_ns
+                  << ", \"p99\": " << result.p99_ns
+                  << ", \"p999\": " << result.p999_ns
+                  << ", \"max\": " << result.max_ns << "}"
+                  << ", \"cpu_ns_per_msg\": " << result.cpu_ns_per_message
+                  << ", \"allocs_per_msg\": " << std::setprecision(3) << result.allocs_per_message
+                  << "}" << std::defaultfloat << std::flush;
+        first = false;
+    }
+};
+
+template<std::size_t Size>
+void RunPayload(Suite& suite) {
+    using T = Payload<Size>;
+    const Topology topologies[] = {Topology::kSpsc, Topology::kMpsc, Topology::kSpmc, Topology::kMpmc};
+
+    for (int capacity : {1, 16, 1024, 65536}) {
+        // Кольцо выделяется целиком: 64k слотов по 64 КБ не влезут в память
+        if (static_cast<unsigned long long>(capacity) * Size > (256ULL << 20)) continue;
+
+        for (bool pinned : {false, true}) {
+            for (Topology topology : topologies) {
+                suite.Run<BufferedChannel<T>, T>("BufferedChannel", topology, capacity, Size, pinned,
+                    MakeChannel<BufferedChannel<T>>);
+                suite.Run<BufferedChannel<T, SpinFutexWaiter>, T>("BufferedChannel<SpinFutex>", topology,
+                    capacity, Size, pinned, MakeChannel<BufferedChannel<T, SpinFutexWaiter>>);
+                suite.Run<MpmcChannel<T>, T>("MpmcChannel", topology, capacity, Size, pinned,
+                    MakeChannel<MpmcChannel<T>>);
+                suite.Run<ShardedChannel<T>, T>("ShardedChannel", topology, capacity, Size, pinned,
+                    MakeShardedChannel<T>);
+                // Без буфера емкость одна - 0; прогоняем вместе со строкой емкости 1
+                if (capacity == 1) {
+                    suite.Run<RendezvousChannel<T>, T>("RendezvousChannel", topology, 0, Size, pinned,
+                        MakeRendezvousChannel<T>);
+                }
+                if (topology == Topology::kSpsc) {
+                    suite.Run<SpscChannel<T>, T>("SpscChannel", topology, capacity, Size, pinned,
+                        MakeChannel<SpscChannel<T>>);
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Suite suite;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--quick") {
+            suite.quick = true;
+        } else if (arg.rfind("--only=", 0) == 0) {
+            suite.only = arg.substr(7);
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            suite.threads = std::max(1, std::atoi(arg.c_str() + 10));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--quick] [--only=<variant/topology/capacity/payload/pinned>] [--threads=N]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "{\n  \"cpus\": " << std::thread::hardware_concurrency()
+              << ",\n  \"threads_per_side\": " << suite.threads
+              << ",\n  \"quick\": " << (suite.quick ? "true" : "false")
+              << ",\n  \"results\": [";
+
+    RunPayload<8>(suite);
+    RunPayload<64>(suite);
+    RunPayload<1024>(suite);
+    RunPayload<65536>(suite);
+
+    std::cout << "\n  ]\n}" << std::endl;
+    return 0;
+}
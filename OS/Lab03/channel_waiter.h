@@ -0,0 +1,178 @@
+#ifndef CHANNEL_WAITER_H_
+#define CHANNEL_WAITER_H_
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "futex.h"
+
+// Стратегии ожидания для BufferedChannel. Обе вызываются под мьютексом канала
+// и имеют одинаковый интерфейс:
+//   Wait(lock, pred), WaitUntil(lock, deadline, pred) -> pred() в конце,
+//   NotifyOne(), NotifyAll() - ничего не делают, если никто не ждет.
+
+// Подсказка процессору внутри цикла ожидания
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Обычная условная переменная, но notify вызывается только при наличии ждущих
+class CondVarWaiter {
+public:
+    struct Options {};
+
+    explicit CondVarWaiter(const Options& = {}) {}
+
+    template<class Pred>
+    void Wait(std::unique_lock<std::mutex>& lock, Pred pred) {
+        while (!pred()) {
+            ++waiters_;
+            cv_.wait(lock);
+            --waiters_;
+        }
+    }
+
+    // Истекший дедлайн проверяем сами: wait_until все равно ушел бы в ядро
+    template<class Pred, class Clock, class Duration>
+    bool WaitUntil(std::unique_lock<std::mutex>& lock,
+                   const std::chrono::time_point<Clock, Duration>& deadline, Pred pred) {
+        while (!pred()) {
+            if (!(Clock::now() < deadline)) {
+                return false;
+            }
+            ++waiters_;
+            std::cv_status status = cv_.wait_until(lock, deadline);
+            --waiters_;
+            if (status == std::cv_status::timeout) {
+                return pred();
+            }
+        }
+        return true;
+    }
+
+    void NotifyOne() {
+        if (waiters_ > 0) cv_.notify_one();
+    }
+
+    void NotifyAll() {
+        if (waiters_ > 0) cv_.notify_all();
+    }
+
+private:
+    std::condition_variable cv_;
+    int waiters_ = 0;
+};
+
+struct SpinFutexOptions {
+    // Итераций с pause до парковки на futex; 0 - сразу парковаться
+    int spin_iterations = 500;
+};
+
+// Сначала крутится spin_iterations итераций с pause, отпустив мьютекс,
+// и только потом паркуется на futex. Публикующая сторона увеличивает seq_,
+// только если есть ждущие, и делает системный вызов, только если кто-то
+// уже припаркован - при быстрой передаче ядро не участвует вовсе.
+class SpinFutexWaiter {
+public:
+    using Options = SpinFutexOptions;
+
+    // На одном процессоре кручение только съедает квант той стороны,
+    // которая должна нас разбудить, поэтому там сразу паркуемся
+    explicit SpinFutexWaiter(const Options& options = {})
+        : spin_iterations_(std::thread::hardware_concurrency() > 1 ? options.spin_iterations : 0) {}
+
+    template<class Pred>
+    void Wait(std::unique_lock<std::mutex>& lock, Pred pred) {
+        while (!pred()) {
+            uint32_t key = Enter(lock);
+            if (!Spin(key)) {
+                parked_.fetch_add(1, std::memory_order_seq_cst);
+                FutexWait(&seq_, key);
+                parked_.fetch_sub(1, std::memory_order_relaxed);
+            }
+            Leave(lock);
+        }
+    }
+
+    template<class Pred, class Clock, class Duration>
+    bool WaitUntil(std::unique_lock<std::mutex>& lock,
+                   const std::chrono::time_point<Clock, Duration>& deadline, Pred pred) {
+        // futex ждет по CLOCK_MONOTONIC, поэтому переводим дедлайн в steady_clock
+        auto steady_deadline = std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(deadline - Clock::now());
+
+        while (!pred()) {
+            if (!(std::chrono::steady_clock::now() < steady_deadline)) {
+                return false;
+            }
+            uint32_t key = Enter(lock);
+            bool woken = Spin(key);
+            if (!woken) {
+                parked_.fetch_add(1, std::memory_order_seq_cst);
+                woken = FutexWaitUntil(&seq_, key, steady_deadline);
+                parked_.fetch_sub(1, std::memory_order_relaxed);
+            }
+            Leave(lock);
+            if (!woken) {
+                return pred();
+            }
+        }
+        return true;
+    }
+
+    void NotifyOne() { Notify(1); }
+    void NotifyAll() { Notify(INT_MAX); }
+
+private:
+    // seq_ меняется только под мьютексом, так что key точно соответствует pred()
+    uint32_t Enter(std::unique_lock<std::mutex>& lock) {
+        uint32_t key = seq_.load(std::memory_order_relaxed);
+        ++waiters_;
+        lock.unlock();
+        return key;
+    }
+
+    void Leave(std::unique_lock<std::mutex>& lock) {
+        lock.lock();
+        --waiters_;
+    }
+
+    // true - состояние изменилось, пока крутились
+    bool Spin(uint32_t key) {
+        for (int i = 0; i < spin_iterations_; ++i) {
+            if (seq_.load(std::memory_order_acquire) != key) {
+                return true;
+            }
+            CpuRelax();
+        }
+        return false;
+    }
+
+    // Парковка: parked_++ затем FUTEX_WAIT(seq_ == key); публикация: seq_++ затем
+    // чтение parked_. Обе стороны seq_cst, так что хотя бы одна видит другую.
+    void Notify(int count) {
+        if (waiters_ == 0) {
+            return;
+        }
+        seq_.fetch_add(1, std::memory_order_seq_cst);
+        if (parked_.load(std::memory_order_seq_cst) > 0) {
+            FutexWake(&seq_, count);
+        }
+    }
+
+    const int spin_iterations_;
+    int waiters_ = 0;
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<uint32_t> parked_{0};
+};
+
+#endif // CHANNEL_WAITER_H_
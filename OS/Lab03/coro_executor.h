@@ -0,0 +1,146 @@
+#ifndef CORO_EXECUTOR_H_
+#define CORO_EXECUTOR_H_
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class Executor;
+
+// Корутина "запустил и забыл" для Executor::Spawn. Стартует только на
+// исполнителе; кадр уничтожается сам после завершения. Исключение,
+// вылетевшее из задачи, завершает программу, как и в std::thread.
+class Task {
+public:
+    struct promise_type {
+        Executor* executor = nullptr;
+
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        ~promise_type();
+    };
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+private:
+    friend class Executor;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// Пул потоков, возобновляющий корутины. Каналы будят приостановленную
+// корутину через Schedule того исполнителя, на котором она уснула.
+class Executor {
+public:
+    explicit Executor(int threads) {
+        for (int i = 0; i < threads; ++i) {
+            threads_.emplace_back([this]() { Worker(); });
+        }
+    }
+
+    ~Executor() {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            stopping_ = true;
+        }
+        ready_cv_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    void Spawn(Task task) {
+        auto handle = std::exchange(task.handle_, nullptr);
+        handle.promise().executor = this;
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            ++active_tasks_;
+        }
+        Schedule(handle);
+    }
+
+    void Schedule(std::coroutine_handle<> handle) {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            ready_.push_back(handle);
+        }
+        ready_cv_.notify_one();
+    }
+
+    // Ждет завершения всех запущенных задач
+    void WaitIdle() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        idle_cv_.wait(lock, [this]() { return active_tasks_ == 0; });
+    }
+
+    // Исполнитель текущего потока или nullptr вне рабочих потоков
+    static Executor*& Current() {
+        thread_local Executor* current = nullptr;
+        return current;
+    }
+
+private:
+    friend struct Task::promise_type;
+
+    void TaskDone() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (--active_tasks_ == 0) {
+            idle_cv_.notify_all();
+        }
+    }
+
+    void Worker() {
+        Current() = this;
+        while (true) {
+            std::coroutine_handle<> handle;
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                ready_cv_.wait(lock, [this]() { return !ready_.empty() || stopping_; });
+                if (ready_.empty()) {
+                    break;
+                }
+                handle = ready_.front();
+                ready_.pop_front();
+            }
+            handle.resume();
+        }
+        Current() = nullptr;
+    }
+
+    std::mutex mtx_;
+    std::condition_variable ready_cv_;
+    std::condition_variable idle_cv_;
+    std::deque<std::coroutine_handle<>> ready_;
+    std::size_t active_tasks_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+};
+
+inline Task::promise_type::~promise_type() {
+    if (executor) executor->TaskDone();
+}
+
+#endif // CORO_EXECUTOR_H_
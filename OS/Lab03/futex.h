@@ -0,0 +1,111 @@
+#ifndef FUTEX_H_
+#define FUTEX_H_
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Тонкая обертка над futex(2) для 32-битных атомиков.
+// shared = true нужен для слова в памяти, разделяемой между процессами,
+// иначе используется более дешевый FUTEX_PRIVATE_FLAG.
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "futex word must be a plain 32-bit integer");
+
+inline long FutexCall(std::atomic<uint32_t>* addr, int op, uint32_t value,
+                      const timespec* timeout, uint32_t bitset, bool shared) {
+    if (!shared) op |= FUTEX_PRIVATE_FLAG;
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), op, value,
+                   timeout, nullptr, bitset);
+}
+
+// Спит, пока *addr == expected и нет пробуждения (возможны ложные пробуждения)
+inline void FutexWait(std::atomic<uint32_t>* addr, uint32_t expected, bool shared = false) {
+    FutexCall(addr, FUTEX_WAIT, expected, nullptr, 0, shared);
+}
+
+// То же с абсолютным дедлайном по steady_clock (CLOCK_MONOTONIC).
+// false - дедлайн истек
+inline bool FutexWaitUntil(std::atomic<uint32_t>* addr, uint32_t expected,
+                           std::chrono::steady_clock::time_point deadline,
+                           bool shared = false) {
+    auto since_epoch = deadline.time_since_epoch();
+    auto secs = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+    auto nsecs = std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - secs);
+    if (secs.count() < 0) {
+        return false;
+    }
+    timespec abs_timeout;
+    abs_timeout.tv_sec = static_cast<time_t>(secs.count());
+    abs_timeout.tv_nsec = static_cast<long>(nsecs.count());
+
+    long rc = FutexCall(addr, FUTEX_WAIT_BITSET, expected, &abs_timeout,
+                        FUTEX_BITSET_MATCH_ANY, shared);
+    return !(rc == -1 && errno == ETIMEDOUT);
+}
+
+inline void FutexWake(std::atomic<uint32_t>* addr, int count, bool shared = false) {
+    FutexCall(addr, FUTEX_WAKE, static_cast<uint32_t>(count), nullptr, 0, shared);
+}
+
+inline void FutexWakeAll(std::atomic<uint32_t>* addr, bool shared = false) {
+    FutexWake(addr, INT_MAX, shared);
+}
+
+// Счетчик событий для парковки без мьютекса.
+// Ожидающий: key = PrepareWait(); перепроверить условие; Wait(key) или CancelWait().
+// Публикующий: изменить состояние, затем Notify*() - системный вызов делается
+// только если кто-то действительно ждет.
+class EventCount {
+public:
+    uint32_t PrepareWait() {
+        uint32_t key = seq_.load(std::memory_order_acquire);
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return key;
+    }
+
+    void CancelWait() {
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void Wait(uint32_t key) {
+        FutexWait(&seq_, key);
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // false - дедлайн истек
+    bool WaitUntil(uint32_t key, std::chrono::steady_clock::time_point deadline) {
+        bool woken = FutexWaitUntil(&seq_, key, deadline);
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+        return woken;
+    }
+
+    void NotifyOne() { Notify(1); }
+    void NotifyAll() { Notify(INT_MAX); }
+
+    bool HasWaiters() const {
+        return waiters_.load(std::memory_order_relaxed) != 0;
+    }
+
+private:
+    void Notify(int count) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        seq_.fetch_add(1, std::memory_order_release);
+        FutexWake(&seq_, count);
+    }
+
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<uint32_t> waiters_{0};
+};
+
+#endif // FUTEX_H_
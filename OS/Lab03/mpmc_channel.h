@@ -0,0 +1,302 @@
+#ifndef MPMC_CHANNEL_H_
+#define MPMC_CHANNEL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "channel_status.h"
+#include "futex.h"
+#include "ring_buffer.h"
+
+// Ограниченный канал для многих отправителей и получателей по схеме Вьюкова:
+// у каждого слота свой номер последовательности, позицию захватывают CAS-ом
+// на enqueue_pos_/dequeue_pos_, а сам слот передается от отправителя
+// получателю через номер слота, без общей блокировки.
+// Ждать (канал полон/пуст) приходится на futex через EventCount.
+// Слотов - степень двойки (не меньше 2: алгоритму нужно хотя бы два слота,
+// чтобы отличать занятый слот от свободного), но элементов в канале
+// одновременно не больше size, как у BufferedChannel.
+//
+// Close() ведет себя как у BufferedChannel: Send после закрытия бросает
+// исключение, Recv отдает оставшиеся элементы и затем {T(), false}.
+// Send, идущий одновременно с Close(), либо бросает, либо кладет элемент,
+// и тогда получатели его обязательно заберут: Recv отвечает "закрыт",
+// только когда не осталось отправителей посреди TryPush (см. pushing_).
+template<class T>
+class MpmcChannel {
+public:
+    explicit MpmcChannel(int size)
+        : capacity_(CheckedCapacity(size, "MpmcChannel")),
+          mask_(RoundUpPow2(capacity_ > 2 ? capacity_ : 2) - 1),
+          cells_(new Cell[mask_ + 1]) {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpmcChannel() {
+        T value;
+        while (TryPop(value)) {}
+    }
+
+    MpmcChannel(const MpmcChannel&) = delete;
+    MpmcChannel& operator=(const MpmcChannel&) = delete;
+
+    std::size_t Capacity() const { return capacity_; }
+
+    void Send(T value) {
+        while (true) {
+            ChannelStatus status = PushUnlessClosed(value);
+            if (status == ChannelStatus::kClosed) {
+                throw std::runtime_error("Channel is closed");
+            }
+            if (status == ChannelStatus::kOk) {
+                not_empty_.NotifyOne();
+                return;
+            }
+
+            uint32_t key = not_full_.PrepareWait();
+            status = PushUnlessClosed(value);
+            if (status != ChannelStatus::kFull) {
+                not_full_.CancelWait();
+                if (status == ChannelStatus::kClosed) {
+                    throw std::runtime_error("Channel is closed");
+                }
+                not_empty_.NotifyOne();
+                return;
+            }
+            not_full_.Wait(key);
+        }
+    }
+
+    std::pair<T, bool> Recv() {
+        T value;
+        while (true) {
+            if (TryPop(value)) {
+                not_full_.NotifyOne();
+                return {std::move(value), true};
+            }
+
+            uint32_t key = not_empty_.PrepareWait();
+            if (TryPop(value)) {
+                not_empty_.CancelWait();
+                not_full_.NotifyOne();
+                return {std::move(value), true};
+            }
+            if (closed_.load(std::memory_order_seq_cst)) {
+                not_empty_.CancelWait();
+                if (!DrainedAfterClose()) {
+                    // Отправитель уже занял слот и вот-вот его опубликует
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (TryPop(value)) {
+                    not_full_.NotifyOne();
+                    return {std::move(value), true};
+                }
+                return {T(), false};
+            }
+            not_empty_.Wait(key);
+        }
+    }
+
+    // Неблокирующие версии: kOk, kFull/kEmpty или kClosed;
+    // value перемещается только при kOk
+    ChannelStatus TrySend(T&& value) {
+        ChannelStatus status = PushUnlessClosed(value);
+        if (status == ChannelStatus::kOk) {
+            not_empty_.NotifyOne();
+        }
+        return status;
+    }
+
+    ChannelStatus TrySend(const T& value) {
+        T copy(value);
+        return TrySend(std::move(copy));
+    }
+
+    // kClosed - только когда канал закрыт и уже ничего не появится
+    ChannelStatus TryRecv(T& out) {
+        bool drained = closed_.load(std::memory_order_seq_cst) && DrainedAfterClose();
+        if (!TryPop(out)) {
+            return drained ? ChannelStatus::kClosed : ChannelStatus::kEmpty;
+        }
+        not_full_.NotifyOne();
+        return ChannelStatus::kOk;
+    }
+
+    // Пакетные версии: слоты по-прежнему захватываются по одному,
+    // но получатели/отправители будятся одним вызовом на порцию
+    template<class InputIt>
+    void SendMany(InputIt first, InputIt last) {
+        while (first != last) {
+            std::size_t sent = 0;
+            while (first != last) {
+                T value = std::move(*first);
+                ChannelStatus status = PushUnlessClosed(value);
+                if (status == ChannelStatus::kClosed) {
+                    NotifyBatch(not_empty_, sent);
+                    throw std::runtime_error("Channel is closed");
+                }
+                if (status == ChannelStatus::kFull) {
+                    // Не поместился - отправляем его обычным Send после пробуждения
+                    NotifyBatch(not_empty_, sent);
+                    sent = 0;
+                    Send(std::move(value));
+                    ++first;
+                    break;
+                }
+                ++first;
+                ++sent;
+            }
+            NotifyBatch(not_empty_, sent);
+        }
+    }
+
+    // Ждет хотя бы один элемент и забирает до out.size(); 0 - закрыт и пуст.
+    // Пустой out - std::invalid_argument, как у BufferedChannel
+    std::size_t RecvMany(std::span<T> out) {
+        if (out.empty()) {
+            throw std::invalid_argument("RecvMany needs a non-empty buffer");
+        }
+        auto [first, ok] = Recv();
+        if (!ok) {
+            return 0;
+        }
+        out[0] = std::move(first);
+
+        std::size_t received = 1;
+        while (received < out.size() && TryPop(out[received])) {
+            ++received;
+        }
+        NotifyBatch(not_full_, received - 1);
+        return received;
+    }
+
+    // Забирает все, что есть сейчас, не блокируясь
+    std::size_t DrainAll(std::vector<T>& out) {
+        std::size_t received = 0;
+        T value;
+        while (TryPop(value)) {
+            out.push_back(std::move(value));
+            ++received;
+        }
+        NotifyBatch(not_full_, received);
+        return received;
+    }
+
+    void Close() {
+        closed_.store(true, std::memory_order_seq_cst);
+        not_full_.NotifyAll();
+        not_empty_.NotifyAll();
+    }
+
+private:
+    struct alignas(kCacheLineSize) Cell {
+        std::atomic<std::size_t> sequence;
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    static void NotifyBatch(EventCount& event, std::size_t count) {
+        if (count == 1) {
+            event.NotifyOne();
+        } else if (count > 1) {
+            event.NotifyAll();
+        }
+    }
+
+    // pushing_ считает отправителей между проверкой closed_ и публикацией слота.
+    // Обе стороны seq_cst: либо отправитель увидит closed_ и не займет слот,
+    // либо получатель, увидевший closed_, увидит и его в pushing_
+    ChannelStatus PushUnlessClosed(T& value) {
+        pushing_.fetch_add(1, std::memory_order_seq_cst);
+        ChannelStatus status = ChannelStatus::kClosed;
+        if (!closed_.load(std::memory_order_seq_cst)) {
+            status = TryPush(value) ? ChannelStatus::kOk : ChannelStatus::kFull;
+        }
+        pushing_.fetch_sub(1, std::memory_order_release);
+        return status;
+    }
+
+    // После Close(): все занятые слоты опубликованы, TryPop их увидит
+    bool DrainedAfterClose() const {
+        return pushing_.load(std::memory_order_seq_cst) == 0;
+    }
+
+    bool TryPush(T& value) {
+        Cell* cell;
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            // Слотов может быть больше емкости: лишние не занимаем.
+            // Устаревший dequeue_pos_ дает только ложное "полон", а перепроверка
+            // после PrepareWait в Send увидит свежий (барьеры EventCount).
+            // Устаревший pos дает отрицательную разность - его поправит ветка ниже
+            auto used = static_cast<std::intptr_t>(pos - dequeue_pos_.load(std::memory_order_acquire));
+            if (used >= static_cast<std::intptr_t>(capacity_)) {
+                return false;
+            }
+            cell = &cells_[pos & mask_];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // полон
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (cell->data) T(std::move(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPop(T& value) {
+        Cell* cell;
+        std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &cells_[pos & mask_];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // пуст
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        T* item = std::launder(reinterpret_cast<T*>(cell->data));
+        value = std::move(*item);
+        item->~T();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(kCacheLineSize) std::atomic<std::size_t> enqueue_pos_{0};
+    alignas(kCacheLineSize) std::atomic<std::size_t> dequeue_pos_{0};
+    alignas(kCacheLineSize) std::atomic<bool> closed_{false};
+    std::atomic<uint32_t> pushing_{0};
+    alignas(kCacheLineSize) EventCount not_full_;
+    alignas(kCacheLineSize) EventCount not_empty_;
+};
+
+#endif // MPMC_CHANNEL_H_
@@ -0,0 +1,173 @@
+#ifndef PRIORITY_CHANNEL_H_
+#define PRIORITY_CHANNEL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "channel_status.h"
+#include "ring_buffer.h"
+
+// Канал с несколькими полосами приоритета: 0 - самая срочная.
+// Recv берет из самой срочной непустой полосы, так что служебные сообщения
+// (остановка, перенастройка) не стоят в очереди за массовыми данными.
+// Внутри полосы порядок FIFO. Емкость задается для каждой полосы отдельно.
+//
+// Старение против голодания: если непустую полосу обошли aging раз подряд,
+// следующий Recv обслуживает ее вне очереди. aging = 0 - строгий приоритет.
+template<class T>
+class PriorityChannel {
+public:
+    PriorityChannel(const std::vector<int>& lane_capacities, int aging = 0)
+        : aging_(aging > 0 ? aging : 0) {
+        if (lane_capacities.empty()) {
+            throw std::invalid_argument("PriorityChannel needs at least one lane");
+        }
+        for (int capacity : lane_capacities) {
+            lanes_.push_back(std::make_unique<Lane>(CheckedCapacity(capacity, "PriorityChannel")));
+        }
+    }
+
+    int Lanes() const { return static_cast<int>(lanes_.size()); }
+
+    void Send(T value, int priority) {
+        Lane& lane = LaneAt(priority);
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        ++lane.send_waiters;
+        lane.send_cv.wait(lock, [this, &lane]() {
+            return lane.buffer.Size() < lane.capacity || closed_;
+        });
+        --lane.send_waiters;
+
+        if (closed_) {
+            throw std::runtime_error("Channel is closed");
+        }
+        PushLocked(lane, std::move(value));
+    }
+
+    ChannelStatus TrySend(T&& value, int priority) {
+        Lane& lane = LaneAt(priority);
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        if (closed_) {
+            return ChannelStatus::kClosed;
+        }
+        if (lane.buffer.Size() >= lane.capacity) {
+            return ChannelStatus::kFull;
+        }
+        PushLocked(lane, std::move(value));
+        return ChannelStatus::kOk;
+    }
+
+    std::pair<T, bool> Recv() {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        ++recv_waiters_;
+        recv_cv_.wait(lock, [this]() {
+            return size_ > 0 || closed_;
+        });
+        --recv_waiters_;
+
+        if (size_ == 0) {
+            return {T(), false};
+        }
+        return {PopLocked(), true};
+    }
+
+    ChannelStatus TryRecv(T& out) {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        if (size_ == 0) {
+            return closed_ ? ChannelStatus::kClosed : ChannelStatus::kEmpty;
+        }
+        out = PopLocked();
+        return ChannelStatus::kOk;
+    }
+
+    void Close() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        closed_ = true;
+        for (auto& lane : lanes_) {
+            lane->send_cv.notify_all();
+        }
+        recv_cv_.notify_all();
+    }
+
+private:
+    struct Lane {
+        explicit Lane(std::size_t size) : capacity(size), buffer(size) {}
+
+        const std::size_t capacity;
+        RingBuffer<T> buffer;
+        std::condition_variable send_cv;
+        int send_waiters = 0;
+        int skipped = 0;  // сколько Recv подряд обошли эту непустую полосу
+    };
+
+    Lane& LaneAt(int priority) {
+        if (priority < 0 || priority >= Lanes()) {
+            throw std::out_of_range("No such priority lane");
+        }
+        return *lanes_[priority];
+    }
+
+    void PushLocked(Lane& lane, T&& value) {
+        lane.buffer.Emplace(std::move(value));
+        ++size_;
+        if (recv_waiters_ > 0) {
+            recv_cv_.notify_one();
+        }
+    }
+
+    T PopLocked() {
+        std::size_t chosen = ChooseLaneLocked();
+        Lane& lane = *lanes_[chosen];
+        T value = lane.buffer.PopFront();
+        --size_;
+        if (lane.send_waiters > 0) {
+            lane.send_cv.notify_one();
+        }
+        return value;
+    }
+
+    // Самая срочная непустая полоса, если только какая-то менее срочная
+    // не "состарилась"; обойденным непустым полосам увеличиваем счетчик
+    std::size_t ChooseLaneLocked() {
+        std::size_t chosen = lanes_.size();
+        for (std::size_t i = 0; i < lanes_.size(); ++i) {
+            if (lanes_[i]->buffer.Empty()) {
+                continue;
+            }
+            if (chosen == lanes_.size()) {
+                chosen = i;
+            } else if (aging_ > 0 && lanes_[i]->skipped >= aging_) {
+                chosen = i;
+                break;
+            }
+        }
+        if (aging_ > 0) {
+            for (std::size_t i = 0; i < lanes_.size(); ++i) {
+                if (i != chosen && !lanes_[i]->buffer.Empty()) {
+                    ++lanes_[i]->skipped;
+                }
+            }
+            lanes_[chosen]->skipped = 0;
+        }
+        return chosen;
+    }
+
+    const int aging_;
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::mutex mtx_;
+    std::condition_variable recv_cv_;
+    std::size_t size_ = 0;
+    int recv_waiters_ = 0;
+    bool closed_ = false;
+};
+
+#endif // PRIORITY_CHANNEL_H_
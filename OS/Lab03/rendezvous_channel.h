@@ -0,0 +1,287 @@
+#ifndef RENDEZVOUS_CHANNEL_H_
+#define RENDEZVOUS_CHANNEL_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "channel_status.h"
+#include "channel_waiter.h"
+#include "futex.h"
+
+// Канал без буфера, как make(chan T) в Go: Send возвращается, только когда
+// значение забрал получатель. Буфера нет вовсе - пришедший второй перемещает
+// значение прямо между переменными участников: отправитель в out ждущего
+// Recv, получатель из аргумента ждущего Send. Копирование идет уже вне
+// мьютекса, потому что узел к этому моменту снят с очереди и принадлежит
+// только второй стороне.
+//
+// Ждущие стоят в очередях FIFO узлами на собственном стеке и ждут на своем
+// futex-слове: будится ровно тот, кому передали значение.
+// Select, корутины и eventfd здесь не поддерживаются - для них BufferedChannel.
+template<class T>
+class RendezvousChannel {
+public:
+    explicit RendezvousChannel(const SpinFutexOptions& options = {})
+        : spin_iterations_(std::thread::hardware_concurrency() > 1 ? options.spin_iterations : 0) {}
+
+    RendezvousChannel(const RendezvousChannel&) = delete;
+    RendezvousChannel& operator=(const RendezvousChannel&) = delete;
+
+    void Send(T value) {
+        if (SendNoThrow(std::move(value)) == ChannelStatus::kClosed) {
+            throw std::runtime_error("Channel is closed");
+        }
+    }
+
+    // kOk - значение получено; kClosed - канал закрыт до встречи, значение не доставлено
+    ChannelStatus SendNoThrow(T value) {
+        return SendUntil(std::move(value), std::chrono::steady_clock::time_point::max());
+    }
+
+    std::pair<T, bool> Recv() {
+        T value;
+        bool ok = RecvInto(value);
+        return {std::move(value), ok};
+    }
+
+    // false - канал закрыт
+    bool RecvInto(T& out) {
+        return RecvUntil(out, std::chrono::steady_clock::time_point::max()) == ChannelStatus::kOk;
+    }
+
+    // Успех только при уже ждущей второй стороне: kOk, kFull/kEmpty или kClosed
+    template<class U>
+    ChannelStatus TrySend(U&& value) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (closed_) {
+            return ChannelStatus::kClosed;
+        }
+        if (receivers_.Empty()) {
+            return ChannelStatus::kFull;
+        }
+        Node* receiver = receivers_.PopFront();
+        lock.unlock();
+        *receiver->slot = std::forward<U>(value);
+        receiver->Complete(kDone);
+        return ChannelStatus::kOk;
+    }
+
+    ChannelStatus TryRecv(T& out) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (closed_) {
+            return ChannelStatus::kClosed;
+        }
+        if (senders_.Empty()) {
+            return ChannelStatus::kEmpty;
+        }
+        Node* sender = senders_.PopFront();
+        lock.unlock();
+        out = std::move(*sender->slot);
+        sender->Complete(kDone);
+        return ChannelStatus::kOk;
+    }
+
+    // Ограниченные по времени версии: kOk, kClosed или kTimeout
+    template<class U, class Clock, class Duration>
+    ChannelStatus SendUntil(U&& value, const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (closed_) {
+            return ChannelStatus::kClosed;
+        }
+        if (!receivers_.Empty()) {
+            Node* receiver = receivers_.PopFront();
+            lock.unlock();
+            *receiver->slot = std::forward<U>(value);
+            receiver->Complete(kDone);
+            return ChannelStatus::kOk;
+        }
+        // Временный T (и лишнее перемещение) нужен, только если нам дали
+        // lvalue: rvalue получатель заберет прямо из переменной вызывающего
+        if constexpr (std::is_same_v<U&&, T&&>) {
+            Node self(&value);
+            senders_.PushBack(&self);
+            return Park(self, senders_, lock, deadline);
+        } else {
+            T local(std::forward<U>(value));
+            Node self(&local);
+            senders_.PushBack(&self);
+            return Park(self, senders_, lock, deadline);
+        }
+    }
+
+    template<class U, class Rep, class Period>
+    ChannelStatus SendFor(U&& value, const std::chrono::duration<Rep, Period>& timeout) {
+        return SendUntil(std::forward<U>(value), std::chrono::steady_clock::now() + timeout);
+    }
+
+    template<class Clock, class Duration>
+    ChannelStatus RecvUntil(T& out, const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (closed_) {
+            return ChannelStatus::kClosed;
+        }
+        if (!senders_.Empty()) {
+            Node* sender = senders_.PopFront();
+            lock.unlock();
+            out = std::move(*sender->slot);
+            sender->Complete(kDone);
+            return ChannelStatus::kOk;
+        }
+        Node self(&out);
+        receivers_.PushBack(&self);
+        return Park(self, receivers_, lock, deadline);
+    }
+
+    template<class Rep, class Period>
+    ChannelStatus RecvFor(T& out, const std::chrono::duration<Rep, Period>& timeout) {
+        return RecvUntil(out, std::chrono::steady_clock::now() + timeout);
+    }
+
+    // Все ждущие получают kClosed; отправители, ждавшие встречи, значение не отдают
+    void Close() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        closed_ = true;
+        Node* senders = senders_.TakeAll();
+        Node* receivers = receivers_.TakeAll();
+        lock.unlock();
+
+        CompleteAll(senders, kClosed);
+        CompleteAll(receivers, kClosed);
+    }
+
+private:
+    enum State : uint32_t { kWaiting, kParked, kDone, kClosed };
+
+    // Ждущий участник. Живет на стеке Send/Recv; slot - его значение или его out
+    struct Node {
+        explicit Node(T* value) : slot(value) {}
+
+        // Вызывает сторона, снявшая узел с очереди, уже без мьютекса. После
+        // exchange узел может быть уничтожен, поэтому дальше трогаем только
+        // адрес для FUTEX_WAKE: лишнее пробуждение чужого слова безвредно
+        void Complete(State result) {
+            if (state.exchange(result, std::memory_order_acq_rel) == kParked) {
+                FutexWake(&state, 1);
+            }
+        }
+
+        T* slot;
+        Node* prev = nullptr;
+        Node* next = nullptr;
+        bool queued = true;
+        std::atomic<uint32_t> state{kWaiting};
+    };
+
+    // Двусвязная, чтобы по таймауту узел можно было вынуть из середины
+    class Queue {
+    public:
+        bool Empty() const { return head_ == nullptr; }
+
+        void PushBack(Node* node) {
+            node->prev = tail_;
+            node->next = nullptr;
+            if (tail_) {
+                tail_->next = node;
+            } else {
+                head_ = node;
+            }
+            tail_ = node;
+        }
+
+        Node* PopFront() {
+            Node* node = head_;
+            Remove(node);
+            return node;
+        }
+
+        void Remove(Node* node) {
+            (node->prev ? node->prev->next : head_) = node->next;
+            (node->next ? node->next->prev : tail_) = node->prev;
+            node->queued = false;
+        }
+
+        // Отцепляет всю очередь; узлы связаны через next
+        Node* TakeAll() {
+            Node* head = head_;
+            for (Node* node = head; node; node = node->next) {
+                node->queued = false;
+            }
+            head_ = tail_ = nullptr;
+            return head;
+        }
+
+    private:
+        Node* head_ = nullptr;
+        Node* tail_ = nullptr;
+    };
+
+    static void CompleteAll(Node* node, State result) {
+        while (node) {
+            Node* next = node->next;
+            node->Complete(result);
+            node = next;
+        }
+    }
+
+    // Ждет, пока вторая сторона не завершит узел. По дедлайну узел снимаем
+    // сами, если его еще не забрали; если уже забрали - передача идет прямо
+    // сейчас, и дождаться ее нужно в любом случае
+    template<class Clock, class Duration>
+    ChannelStatus Park(Node& self, Queue& queue, std::unique_lock<std::mutex>& lock,
+                       const std::chrono::time_point<Clock, Duration>& deadline) {
+        lock.unlock();
+
+        bool unbounded = deadline == std::chrono::time_point<Clock, Duration>::max();
+        auto steady_deadline = std::chrono::steady_clock::time_point::max();
+        if (!unbounded) {
+            steady_deadline = std::chrono::steady_clock::now() +
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(deadline - Clock::now());
+        }
+
+        uint32_t state = Spin(self);
+        while (state == kWaiting || state == kParked) {
+            if (state == kWaiting &&
+                !self.state.compare_exchange_strong(state, kParked, std::memory_order_acquire)) {
+                continue;
+            }
+            if (unbounded) {
+                FutexWait(&self.state, kParked);
+            } else if (!FutexWaitUntil(&self.state, kParked, steady_deadline)) {
+                lock.lock();
+                if (self.queued) {
+                    queue.Remove(&self);
+                    return ChannelStatus::kTimeout;
+                }
+                lock.unlock();
+                unbounded = true;
+            }
+            state = self.state.load(std::memory_order_acquire);
+        }
+        return state == kDone ? ChannelStatus::kOk : ChannelStatus::kClosed;
+    }
+
+    uint32_t Spin(Node& self) {
+        for (int i = 0; i < spin_iterations_; ++i) {
+            uint32_t state = self.state.load(std::memory_order_acquire);
+            if (state != kWaiting) {
+                return state;
+            }
+            CpuRelax();
+        }
+        return self.state.load(std::memory_order_acquire);
+    }
+
+    const int spin_iterations_;
+    std::mutex mtx_;
+    bool closed_ = false;
+    Queue senders_;
+    Queue receivers_;
+};
+
+#endif // RENDEZVOUS_CHANNEL_H_
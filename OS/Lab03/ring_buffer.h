@@ -0,0 +1,91 @@
+#ifndef RING_BUFFER_H_
+#define RING_BUFFER_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Размер кэш-линии для разнесения горячих полей
+inline constexpr std::size_t kCacheLineSize = 64;
+
+inline std::size_t RoundUpPow2(std::size_t n) {
+    std::size_t pow2 = 1;
+    while (pow2 < n) {
+        pow2 <<= 1;
+    }
+    return pow2;
+}
+
+// Кольцевой буфер фиксированной емкости (степень двойки, не меньше запрошенной).
+// Память под слоты выделяется один раз в конструкторе, элементы создаются
+// в слотах через placement new и разрушаются при извлечении.
+// Не потокобезопасен: синхронизацию обеспечивает владелец.
+template<class T>
+class RingBuffer {
+public:
+    explicit RingBuffer(std::size_t min_capacity)
+        : mask_(RoundUpPow2(min_capacity) - 1),
+          slots_(new Slot[mask_ + 1]),
+          head_(0),
+          tail_(0) {}
+
+    ~RingBuffer() {
+        while (!Empty()) {
+            Pop();
+        }
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    std::size_t Capacity() const { return mask_ + 1; }
+    std::size_t Size() const { return tail_ - head_; }
+    bool Empty() const { return head_ == tail_; }
+    bool Full() const { return Size() == Capacity(); }
+
+    // Требует !Full()
+    template<class... Args>
+    T& Emplace(Args&&... args) {
+        T* item = new (slots_[tail_ & mask_].data) T(std::forward<Args>(args)...);
+        ++tail_;
+        return *item;
+    }
+
+    void Push(T&& value) { Emplace(std::move(value)); }
+    void Push(const T& value) { Emplace(value); }
+
+    // Требуют !Empty()
+    T& Front() { return *Item(head_); }
+
+    void Pop() {
+        Item(head_)->~T();
+        ++head_;
+    }
+
+    T PopFront() {
+        T value = std::move(Front());
+        Pop();
+        return value;
+    }
+
+    // i-й элемент от начала, i < Size()
+    T& At(std::size_t i) { return *Item(head_ + i); }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    T* Item(std::size_t index) {
+        return std::launder(reinterpret_cast<T*>(slots_[index & mask_].data));
+    }
+
+    const std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    // Индексы растут монотонно, в слот отображаются маской
+    alignas(kCacheLineSize) std::size_t head_;
+    alignas(kCacheLineSize) std::size_t tail_;
+};
+
+#endif // RING_BUFFER_H_
@@ -0,0 +1,210 @@
+#ifndef SELECT_H_
+#define SELECT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include "buhhered_channel.h"
+#include "channel_status.h"
+#include "futex.h"
+#include "select_watcher.h"
+
+// Один вариант Select: отправка в канал или получение из него.
+// Тип канала стерт через указатели на функции, так что массив вариантов
+// не выделяет память.
+class SelectCase {
+public:
+    // Получение: при успехе *out = значение, *ok = true;
+    // закрытый и пустой канал тоже считается готовым, тогда *ok = false
+    template<class T, class Waiter>
+    static SelectCase Recv(BufferedChannel<T, Waiter>& channel, T& out, bool* ok = nullptr) {
+        SelectCase c;
+        c.channel_ = &channel;
+        c.value_ = &out;
+        c.ok_ = ok;
+        c.try_ = [](const SelectCase& self) {
+            auto* ch = static_cast<BufferedChannel<T, Waiter>*>(self.channel_);
+            ChannelStatus status = ch->TryRecv(*static_cast<T*>(self.value_));
+            if (self.ok_ && status != ChannelStatus::kEmpty) {
+                *self.ok_ = status == ChannelStatus::kOk;
+            }
+            return status;
+        };
+        c.watch_ = &WatchImpl<BufferedChannel<T, Waiter>>;
+        c.unwatch_ = &UnwatchImpl<BufferedChannel<T, Waiter>>;
+        return c;
+    }
+
+    // Отправка: value перемещается в канал, только если выбран этот вариант.
+    // Отправка в закрытый канал бросает исключение, как и BufferedChannel::Send
+    template<class T, class Waiter>
+    static SelectCase Send(BufferedChannel<T, Waiter>& channel, T& value) {
+        SelectCase c;
+        c.channel_ = &channel;
+        c.value_ = &value;
+        c.try_ = [](const SelectCase& self) {
+            auto* ch = static_cast<BufferedChannel<T, Waiter>*>(self.channel_);
+            ChannelStatus status = ch->TrySend(std::move(*static_cast<T*>(self.value_)));
+            if (status == ChannelStatus::kClosed) {
+                throw std::runtime_error("Channel is closed");
+            }
+            return status;
+        };
+        c.watch_ = &WatchImpl<BufferedChannel<T, Waiter>>;
+        c.unwatch_ = &UnwatchImpl<BufferedChannel<T, Waiter>>;
+        return c;
+    }
+
+    // kOk/kClosed - вариант выполнен (готов), kFull/kEmpty - не готов
+    ChannelStatus Try() const { return try_(*this); }
+    void Watch(SelectWatcher* watcher) const { watch_(*this, watcher); }
+    void Unwatch(SelectWatcher* watcher) const { unwatch_(*this, watcher); }
+
+private:
+    template<class Channel>
+    static void WatchImpl(const SelectCase& self, SelectWatcher* watcher) {
+        static_cast<Channel*>(self.channel_)->Watch(watcher);
+    }
+
+    template<class Channel>
+    static void UnwatchImpl(const SelectCase& self, SelectWatcher* watcher) {
+        static_cast<Channel*>(self.channel_)->Unwatch(watcher);
+    }
+
+    void* channel_ = nullptr;
+    void* value_ = nullptr;
+    bool* ok_ = nullptr;
+    ChannelStatus (*try_)(const SelectCase&) = nullptr;
+    void (*watch_)(const SelectCase&, SelectWatcher*) = nullptr;
+    void (*unwatch_)(const SelectCase&, SelectWatcher*) = nullptr;
+};
+
+namespace select_detail {
+
+// Небольшой ГПСЧ на поток (xorshift) для случайного порядка опроса
+inline uint32_t NextRandom() {
+    thread_local uint32_t state = static_cast<uint32_t>(
+        reinterpret_cast<std::uintptr_t>(&state) >> 4) | 1u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Буфер на стеке для типичного числа вариантов, куча - только для больших Select
+template<class T, std::size_t kInline = 64>
+class SmallArray {
+public:
+    explicit SmallArray(std::size_t n)
+        : heap_(n > kInline ? new T[n] : nullptr),
+          data_(heap_ ? heap_.get() : inline_) {}
+
+    T& operator[](std::size_t i) { return data_[i]; }
+
+private:
+    T inline_[kInline];
+    std::unique_ptr<T[]> heap_;
+    T* data_;
+};
+
+// Случайная перестановка Фишера-Йетса
+template<class Array>
+void Shuffle(Array& order, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    for (std::size_t i = n; i > 1; --i) {
+        std::size_t j = NextRandom() % i;
+        std::swap(order[i - 1], order[j]);
+    }
+}
+
+// Опрос всех вариантов в порядке order; индекс выполненного или -1
+template<class Array>
+int TryCases(std::span<const SelectCase> cases, Array& order) {
+    for (std::size_t k = 0; k < cases.size(); ++k) {
+        uint32_t i = order[k];
+        ChannelStatus status = cases[i].Try();
+        if (status == ChannelStatus::kOk || status == ChannelStatus::kClosed) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+} // namespace select_detail
+
+// Если ни один вариант не готов - сразу -1 (аналог default в Go)
+inline int TrySelect(std::span<const SelectCase> cases) {
+    select_detail::SmallArray<uint32_t> order(cases.size());
+    select_detail::Shuffle(order, cases.size());
+    return select_detail::TryCases(cases, order);
+}
+
+// Блокируется, пока хотя бы один вариант не станет готов, выполняет ровно один
+// и возвращает его индекс.
+//
+// Справедливость: на каждом проходе варианты опрашиваются в новой случайной
+// перестановке, поэтому из k одновременно готовых вариантов каждый выбирается
+// с вероятностью 1/k, и ни один канал не может голодать.
+//
+// Мьютексы каналов берутся по одному на время TrySend/TryRecv, никогда все сразу.
+// Перед сном Select подписывается на каждый канал (узел на стеке), и любой
+// канал будит его одним futex-пробуждением при изменении своего состояния.
+inline int Select(std::span<const SelectCase> cases) {
+    if (cases.empty()) {
+        throw std::invalid_argument("Select with no cases would block forever");
+    }
+
+    std::size_t n = cases.size();
+    select_detail::SmallArray<uint32_t> order(n);
+    select_detail::Shuffle(order, n);
+
+    int chosen = select_detail::TryCases(cases, order);
+    if (chosen >= 0) {
+        return chosen;
+    }
+
+    EventCount event;
+    select_detail::SmallArray<SelectWatcher> watchers(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        watchers[i].event = &event;
+        cases[i].Watch(&watchers[i]);
+    }
+
+    struct UnwatchAll {
+        std::span<const SelectCase> cases;
+        select_detail::SmallArray<SelectWatcher>& watchers;
+        ~UnwatchAll() {
+            for (std::size_t i = 0; i < cases.size(); ++i) {
+                cases[i].Unwatch(&watchers[i]);
+            }
+        }
+    } guard{cases, watchers};
+
+    while (true) {
+        uint32_t key = event.PrepareWait();
+        chosen = select_detail::TryCases(cases, order);
+        if (chosen >= 0) {
+            event.CancelWait();
+            return chosen;
+        }
+        event.Wait(key);
+        select_detail::Shuffle(order, n);
+    }
+}
+
+inline int Select(std::initializer_list<SelectCase> cases) {
+    return Select(std::span<const SelectCase>(cases.begin(), cases.size()));
+}
+
+inline int TrySelect(std::initializer_list<SelectCase> cases) {
+    return TrySelect(std::span<const SelectCase>(cases.begin(), cases.size()));
+}
+
+#endif // SELECT_H_
@@ -0,0 +1,51 @@
+#ifndef SELECT_WATCHER_H_
+#define SELECT_WATCHER_H_
+
+#include "futex.h"
+
+// Подписка Select на канал: узел интрузивного списка, живет на стеке Select,
+// поэтому подписка и отписка не выделяют память
+struct SelectWatcher {
+    EventCount* event = nullptr;
+    SelectWatcher* prev = nullptr;
+    SelectWatcher* next = nullptr;
+};
+
+// Список подписчиков канала; все методы вызываются под мьютексом канала
+class WatcherList {
+public:
+    void Add(SelectWatcher* watcher) {
+        watcher->prev = nullptr;
+        watcher->next = head_;
+        if (head_) {
+            head_->prev = watcher;
+        }
+        head_ = watcher;
+    }
+
+    void Remove(SelectWatcher* watcher) {
+        if (watcher->prev) {
+            watcher->prev->next = watcher->next;
+        } else {
+            head_ = watcher->next;
+        }
+        if (watcher->next) {
+            watcher->next->prev = watcher->prev;
+        }
+        watcher->prev = watcher->next = nullptr;
+    }
+
+    // Состояние канала изменилось: у каждого Select один ждущий поток
+    void NotifyAll() {
+        for (SelectWatcher* watcher = head_; watcher; watcher = watcher->next) {
+            watcher->event->NotifyOne();
+        }
+    }
+
+    bool Empty() const { return head_ == nullptr; }
+
+private:
+    SelectWatcher* head_ = nullptr;
+};
+
+#endif // SELECT_WATCHER_H_
@@ -0,0 +1,292 @@
+#ifndef SHARDED_CHANNEL_H_
+#define SHARDED_CHANNEL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "channel_status.h"
+#include "futex.h"
+#include "ring_buffer.h"
+
+// Канал для многих получателей: у каждого получателя своя полоса со своим
+// мьютексом, так что Recv не борется за одну блокировку со всеми остальными.
+// Отправители раскладывают элементы по кругу (Send) или по хешу ключа
+// (SendKeyed) - тогда элементы одного ключа идут через одну полосу в порядке FIFO.
+//
+// Получатель lane сначала берет из своей полосы; если она пуста и воровство
+// включено, забирает из чужих. Элементы одного ключа по-прежнему извлекаются
+// в порядке отправки, но обрабатываться могут разными получателями
+// одновременно; если важна строгая привязка ключа к получателю, steal = false.
+//
+// Простаивающие получатели паркуются на EventCount: пока все заняты,
+// отправка не делает системных вызовов.
+template<class T>
+class ShardedChannel {
+public:
+    ShardedChannel(int lanes, int lane_capacity, bool steal = true)
+        : steal_(steal) {
+        if (lanes <= 0) {
+            throw std::invalid_argument("ShardedChannel needs at least one lane");
+        }
+        for (int i = 0; i < lanes; ++i) {
+            lanes_.push_back(std::make_unique<Lane>(CheckedCapacity(lane_capacity, "ShardedChannel")));
+        }
+    }
+
+    ShardedChannel(const ShardedChannel&) = delete;
+    ShardedChannel& operator=(const ShardedChannel&) = delete;
+
+    int Lanes() const { return static_cast<int>(lanes_.size()); }
+
+    // По кругу; заполненные полосы пропускаются, ждем только если полны все
+    void Send(T value) {
+        std::size_t start = NextLane();
+        for (std::size_t i = 0; i < lanes_.size(); ++i) {
+            ChannelStatus status = TryPushLane(LaneFor(start + i), value);
+            if (status == ChannelStatus::kOk) {
+                return;
+            }
+            if (status == ChannelStatus::kClosed) {
+                throw std::runtime_error("Channel is closed");
+            }
+        }
+        PushLane(LaneFor(start), std::move(value));
+    }
+
+    // Все элементы одного ключа попадают в одну полосу
+    template<class Key, class Hash = std::hash<Key>>
+    void SendKeyed(const Key& key, T value) {
+        PushLane(LaneFor(Hash()(key)), std::move(value));
+    }
+
+    ChannelStatus TrySend(T&& value) {
+        std::size_t start = NextLane();
+        for (std::size_t i = 0; i < lanes_.size(); ++i) {
+            ChannelStatus status = TryPushLane(LaneFor(start + i), value);
+            if (status != ChannelStatus::kFull) {
+                return status;
+            }
+        }
+        return ChannelStatus::kFull;
+    }
+
+    // lane - полоса этого получателя. false - канал закрыт и все,
+    // что получатель может взять, разобрано
+    std::pair<T, bool> Recv(int lane) {
+        T value;
+        bool ok = RecvInto(lane, value);
+        return {std::move(value), ok};
+    }
+
+    bool RecvInto(int lane, T& out) {
+        std::size_t home = HomeLane(lane);
+        std::size_t left = 0;
+        bool woken = false;
+        while (true) {
+            if (TryPopAny(home, out, &left)) {
+                // Отправитель будит только на переходе полосы из пустой
+                // в непустую; проснувшийся передает эстафету следующему
+                if (woken && steal_ && left > 0) {
+                    idle_.NotifyOne();
+                }
+                return true;
+            }
+            EventCount& event = steal_ ? idle_ : lanes_[home]->ready;
+            uint32_t key = event.PrepareWait();
+            if (TryPopAny(home, out, &left)) {
+                event.CancelWait();
+                return true;
+            }
+            if (closed_.load(std::memory_order_seq_cst)) {
+                event.CancelWait();
+                // Последняя проверка: элемент мог лечь перед самым Close
+                return TryPopAny(home, out, &left);
+            }
+            event.Wait(key);
+            woken = true;
+        }
+    }
+
+    ChannelStatus TryRecv(int lane, T& out) {
+        std::size_t left = 0;
+        if (TryPopAny(HomeLane(lane), out, &left)) {
+            return ChannelStatus::kOk;
+        }
+        return closed_.load(std::memory_order_seq_cst) ? ChannelStatus::kClosed
+                                                       : ChannelStatus::kEmpty;
+    }
+
+    void Close() {
+        {
+            // Под мьютексами всех полос: любая отправка либо увидит closed_,
+            // либо завершится раньше и будет видна получателю, увидевшему closed_
+            std::vector<std::unique_lock<std::mutex>> locks;
+            for (auto& lane : lanes_) {
+                locks.emplace_back(lane->mtx);
+            }
+            closed_.store(true, std::memory_order_seq_cst);
+        }
+        idle_.NotifyAll();
+        for (auto& lane : lanes_) {
+            lane->ready.NotifyAll();
+            lane->not_full.NotifyAll();
+        }
+    }
+
+    // Сколько элементов получатели забрали из чужих полос
+    uint64_t Steals() const {
+        return steals_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct alignas(kCacheLineSize) Lane {
+        explicit Lane(std::size_t size) : capacity(size), buffer(size) {}
+
+        const std::size_t capacity;
+        std::mutex mtx;
+        RingBuffer<T> buffer;
+        // Копия размера для чтения без мьютекса: ворующие пропускают пустые полосы
+        std::atomic<std::size_t> size{0};
+        EventCount not_full;
+        EventCount ready;  // ждет хозяин полосы, если воровство выключено
+    };
+
+    // Курсор свой у каждого канала (thread_local был бы общим для всех
+    // каналов потока). relaxed: нужна только разная полоса, не порядок
+    std::size_t NextLane() {
+        return next_lane_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Lane& LaneFor(std::size_t hash) {
+        return *lanes_[hash % lanes_.size()];
+    }
+
+    std::size_t HomeLane(int lane) const {
+        if (lane < 0 || lane >= Lanes()) {
+            throw std::out_of_range("No such lane");
+        }
+        return static_cast<std::size_t>(lane);
+    }
+
+    // value перемещается только при kOk; space - сколько мест осталось
+    ChannelStatus TryPushLane(Lane& lane, T& value, std::size_t* space = nullptr) {
+        bool was_empty;
+        {
+            std::unique_lock<std::mutex> lock(lane.mtx);
+            if (closed_.load(std::memory_order_relaxed)) {
+                return ChannelStatus::kClosed;
+            }
+            if (lane.buffer.Size() >= lane.capacity) {
+                return ChannelStatus::kFull;
+            }
+            was_empty = lane.buffer.Empty();
+            lane.buffer.Emplace(std::move(value));
+            lane.size.store(lane.buffer.Size(), std::memory_order_relaxed);
+            if (space) {
+                *space = lane.capacity - lane.buffer.Size();
+            }
+        }
+        // Получатель паркуется, только просмотрев полосы пустыми, так что
+        // будить нужно лишь на переходе из пустой в непустую
+        if (was_empty) {
+            NotifyReady(lane);
+        }
+        return ChannelStatus::kOk;
+    }
+
+    void PushLane(Lane& lane, T&& value) {
+        bool waited = false;
+        while (true) {
+            std::size_t space = 0;
+            ChannelStatus status = TryPushLane(lane, value, &space);
+            if (status == ChannelStatus::kOk) {
+                // Получатель будит на переходе из полной в неполную одного
+                // отправителя; место еще есть - будим следующего
+                if (waited && space > 0) {
+                    lane.not_full.NotifyOne();
+                }
+                return;
+            }
+            if (status == ChannelStatus::kClosed) {
+                throw std::runtime_error("Channel is closed");
+            }
+            uint32_t key = lane.not_full.PrepareWait();
+            bool full;
+            {
+                std::unique_lock<std::mutex> lock(lane.mtx);
+                full = lane.buffer.Size() >= lane.capacity &&
+                       !closed_.load(std::memory_order_relaxed);
+            }
+            if (full) {
+                lane.not_full.Wait(key);
+                waited = true;
+            } else {
+                lane.not_full.CancelWait();
+            }
+        }
+    }
+
+    void NotifyReady(Lane& lane) {
+        if (steal_) {
+            // Разбудить любого простаивающего: свою полосу он проверит первой,
+            // а если элемент лег в чужую - украдет его
+            idle_.NotifyOne();
+        } else {
+            lane.ready.NotifyOne();
+        }
+    }
+
+    // left - сколько элементов осталось в полосе
+    bool TryPop(Lane& lane, T& out, std::size_t* left) {
+        if (lane.size.load(std::memory_order_relaxed) == 0) {
+            return false;
+        }
+        bool was_full;
+        {
+            std::unique_lock<std::mutex> lock(lane.mtx);
+            if (lane.buffer.Empty()) {
+                return false;
+            }
+            was_full = lane.buffer.Size() >= lane.capacity;
+            out = lane.buffer.PopFront();
+            *left = lane.buffer.Size();
+            lane.size.store(*left, std::memory_order_relaxed);
+        }
+        if (was_full) {
+            lane.not_full.NotifyOne();
+        }
+        return true;
+    }
+
+    bool TryPopAny(std::size_t home, T& out, std::size_t* left) {
+        if (TryPop(*lanes_[home], out, left)) {
+            return true;
+        }
+        if (!steal_) {
+            return false;
+        }
+        for (std::size_t i = 1; i < lanes_.size(); ++i) {
+            if (TryPop(*lanes_[(home + i) % lanes_.size()], out, left)) {
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const bool steal_;
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::atomic<bool> closed_{false};
+    alignas(kCacheLineSize) EventCount idle_;
+    alignas(kCacheLineSize) std::atomic<uint64_t> steals_{0};
+    alignas(kCacheLineSize) std::atomic<std::size_t> next_lane_{0};
+};
+
+#endif // SHARDED_CHANNEL_H_
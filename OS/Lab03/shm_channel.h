@@ -0,0 +1,473 @@
+#ifndef SHM_CHANNEL_H_
+#define SHM_CHANNEL_H_
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+
+#include "channel_status.h"
+#include "futex.h"
+#include "ring_buffer.h"
+
+// Канал между процессами в разделяемой памяти (shm_open или memfd_create).
+// Элементы копируются memcpy прямо в сегмент, поэтому T - тривиально копируемый.
+// Состояние защищено робастным межпроцессным мьютексом, ожидание - на futex
+// без FUTEX_PRIVATE_FLAG.
+//
+// Смерть соседа: если процесс умер с захваченным мьютексом, следующий захват
+// получает EOWNERDEAD; если он умер в любой другой момент, ждущая сторона
+// раз в kPeerCheckInterval проверяет зарегистрированные pid. В обоих случаях
+// канал помечается закрытым и PeerDead() == true: Recv дочитывает оставшееся
+// и возвращает false, Send бросает исключение.
+template<class T>
+class ShmChannel {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "ShmChannel copies items between processes with memcpy");
+
+public:
+    static constexpr auto kPeerCheckInterval = std::chrono::milliseconds(50);
+
+    // Именованный сегмент /name; создатель удаляет имя в деструкторе
+    // (только в создавшем процессе - не в потомке после fork)
+    static ShmChannel Create(const std::string& name, int capacity) {
+        CheckedCapacity(capacity, "ShmChannel");
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd == -1) {
+            throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+        }
+        try {
+            ShmChannel channel(fd, capacity);
+            channel.name_ = name;
+            channel.creator_pid_ = getpid();
+            return channel;
+        } catch (...) {
+            // Конструктор уже закрыл fd; без unlink имя осталось бы
+            // в /dev/shm, и следующий Create с ним падал бы с EEXIST
+            shm_unlink(name.c_str());
+            throw;
+        }
+    }
+
+    static ShmChannel Open(const std::string& name) {
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd == -1) {
+            throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+        }
+        return ShmChannel(fd);
+    }
+
+    // Анонимный сегмент: наследуется через fork или передается дочернему
+    // процессу как дескриптор Fd() и открывается через FromFd
+    static ShmChannel CreateAnonymous(int capacity) {
+        CheckedCapacity(capacity, "ShmChannel");
+        int fd = memfd_create("shm_channel", 0);
+        if (fd == -1) {
+            throw std::system_error(errno, std::generic_category(), "memfd_create");
+        }
+        return ShmChannel(fd, capacity);
+    }
+
+    static ShmChannel FromFd(int fd) {
+        int own = dup(fd);
+        if (own == -1) {
+            throw std::system_error(errno, std::generic_category(), "dup");
+        }
+        return ShmChannel(own);
+    }
+
+    ShmChannel(ShmChannel&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1)),
+          size_(std::exchange(other.size_, 0)),
+          header_(std::exchange(other.header_, nullptr)),
+          slots_(std::exchange(other.slots_, nullptr)),
+          attached_pid_(std::exchange(other.attached_pid_, 0)),
+          creator_pid_(std::exchange(other.creator_pid_, 0)),
+          name_(std::move(other.name_)) {
+        other.name_.clear();
+    }
+
+    ShmChannel(const ShmChannel&) = delete;
+    ShmChannel& operator=(const ShmChannel&) = delete;
+    ShmChannel& operator=(ShmChannel&&) = delete;
+
+    ~ShmChannel() {
+        if (!header_) {
+            return;
+        }
+        // Деструктор не бросает: если мьютекс невосстановим, просто не снимаем регистрацию
+        if (attached_pid_ == getpid() && LockNoThrow() == 0) {
+            Detach();
+            Unlock();
+        }
+        Release();
+        if (!name_.empty() && creator_pid_ == getpid()) {
+            shm_unlink(name_.c_str());
+        }
+    }
+
+    int Fd() const { return fd_; }
+
+    // Регистрирует текущий процесс как участника для обнаружения смерти соседей.
+    // Конструкторы делают это сами; после fork унаследованный канал нужно
+    // зарегистрировать в дочернем процессе заново. Если все kMaxPeers мест
+    // заняты, бросает: незарегистрированного соседа никто не проверял бы на смерть
+    void Attach() {
+        Lock();
+        bool attached = AttachLocked();
+        Unlock();
+        if (!attached) {
+            throw TooManyPeers();
+        }
+    }
+
+    void Send(const T& value) {
+        if (SendNoThrow(value) == ChannelStatus::kClosed) {
+            throw std::runtime_error(PeerDead() ? "Peer process died" : "Channel is closed");
+        }
+    }
+
+    ChannelStatus SendNoThrow(const T& value) {
+        Lock();
+        while (!header_->closed && header_->tail - header_->head >= header_->capacity) {
+            WaitLocked(header_->send_seq, header_->send_waiters);
+        }
+        ChannelStatus status = ChannelStatus::kClosed;
+        if (!header_->closed) {
+            PushLocked(value);
+            status = ChannelStatus::kOk;
+        }
+        Unlock();
+        return status;
+    }
+
+    std::pair<T, bool> Recv() {
+        std::pair<T, bool> result{};
+        Lock();
+        while (!header_->closed && header_->tail == header_->head) {
+            WaitLocked(header_->recv_seq, header_->recv_waiters);
+        }
+        if (header_->tail != header_->head) {
+            PopLocked(result.first);
+            result.second = true;
+        }
+        Unlock();
+        return result;
+    }
+
+    ChannelStatus TrySend(const T& value) {
+        Lock();
+        ChannelStatus status = ChannelStatus::kOk;
+        if (header_->closed) {
+            status = ChannelStatus::kClosed;
+        } else if (header_->tail - header_->head >= header_->capacity) {
+            status = ChannelStatus::kFull;
+        } else {
+            PushLocked(value);
+        }
+        Unlock();
+        return status;
+    }
+
+    ChannelStatus TryRecv(T& out) {
+        Lock();
+        ChannelStatus status = ChannelStatus::kOk;
+        if (header_->tail != header_->head) {
+            PopLocked(out);
+        } else {
+            status = header_->closed ? ChannelStatus::kClosed : ChannelStatus::kEmpty;
+        }
+        Unlock();
+        return status;
+    }
+
+    void Close() {
+        Lock();
+        CloseLocked();
+        Unlock();
+    }
+
+    bool PeerDead() {
+        Lock();
+        bool dead = header_->peer_dead;
+        Unlock();
+        return dead;
+    }
+
+private:
+    static constexpr uint32_t kMagic = 0x43484e31;  // "CHN1"
+    static constexpr int kMaxPeers = 16;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t item_size;
+        uint64_t capacity;
+        uint64_t mask;
+        pthread_mutex_t mtx;
+        uint64_t head;
+        uint64_t tail;
+        uint32_t send_waiters;
+        uint32_t recv_waiters;
+        bool closed;
+        bool peer_dead;
+        uint32_t peers_died;
+        pid_t peers[kMaxPeers];
+        // Слова futex на отдельных линиях от полей под мьютексом
+        alignas(kCacheLineSize) std::atomic<uint32_t> send_seq;
+        alignas(kCacheLineSize) std::atomic<uint32_t> recv_seq;
+    };
+
+    static std::size_t SlotsOffset() {
+        return (sizeof(Header) + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+
+    // Создание: размечаем сегмент и инициализируем заголовок.
+    // capacity > 0 уже проверили Create/CreateAnonymous
+    ShmChannel(int fd, int capacity) : fd_(fd) {
+        std::size_t slots = RoundUpPow2(static_cast<std::size_t>(capacity));
+        size_ = SlotsOffset() + slots * sizeof(T);
+        if (ftruncate(fd_, static_cast<off_t>(size_)) == -1) {
+            int error = errno;
+            close(fd_);
+            throw std::system_error(error, std::generic_category(), "ftruncate");
+        }
+        Map();
+
+        Header* header = new (header_) Header();
+        header->item_size = sizeof(T);
+        header->capacity = static_cast<uint64_t>(capacity);
+        header->mask = slots - 1;
+
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&header->mtx, &attr);
+        pthread_mutexattr_destroy(&attr);
+
+        // magic последним: Open не увидит наполовину созданный заголовок
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = kMagic;
+        AttachOrRelease();
+    }
+
+    // Открытие существующего сегмента
+    explicit ShmChannel(int fd) : fd_(fd) {
+        struct stat info;
+        if (fstat(fd_, &info) == -1 || static_cast<std::size_t>(info.st_size) < SlotsOffset()) {
+            close(fd_);
+            throw std::runtime_error("Not a channel segment");
+        }
+        size_ = static_cast<std::size_t>(info.st_size);
+        Map();
+        if (header_->magic != kMagic || header_->item_size != sizeof(T)) {
+            Release();
+            throw std::runtime_error("Channel segment has a different layout");
+        }
+        // Обрезанный или чужой сегмент с тем же magic: иначе первый же
+        // Send/Recv за концом отображения получил бы SIGBUS
+        uint64_t slots = header_->mask + 1;
+        if ((slots & header_->mask) != 0 || header_->capacity == 0 || header_->capacity > slots ||
+            slots > (size_ - SlotsOffset()) / sizeof(T)) {
+            Release();
+            throw std::runtime_error("Channel segment is smaller than its header says");
+        }
+        AttachOrRelease();
+    }
+
+    // Деструктор недостроенного объекта не вызывается, поэтому при ошибке
+    // регистрации (например, ENOTRECOVERABLE из Lock) освобождаем все сами
+    void AttachOrRelease() {
+        try {
+            Attach();
+        } catch (...) {
+            Release();
+            throw;
+        }
+    }
+
+    void Release() {
+        munmap(header_, size_);
+        close(fd_);
+    }
+
+    static std::runtime_error TooManyPeers() {
+        return std::runtime_error("ShmChannel supports at most " + std::to_string(kMaxPeers) +
+                                  " processes");
+    }
+
+    void Map() {
+        void* addr = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (addr == MAP_FAILED) {
+            int error = errno;
+            close(fd_);
+            throw std::system_error(error, std::generic_category(), "mmap");
+        }
+        header_ = static_cast<Header*>(addr);
+        slots_ = static_cast<unsigned char*>(addr) + SlotsOffset();
+    }
+
+    void Lock() {
+        int rc = LockNoThrow();
+        if (rc != 0) {
+            throw std::system_error(rc, std::generic_category(), "pthread_mutex_lock");
+        }
+    }
+
+    // 0 - мьютекс захвачен, иначе код ошибки (например ENOTRECOVERABLE)
+    int LockNoThrow() noexcept {
+        int rc = pthread_mutex_lock(&header_->mtx);
+        if (rc == EOWNERDEAD) {
+            // Сосед умер внутри критической секции. head/tail меняются одной
+            // записью после копирования, так что состояние целостно
+            pthread_mutex_consistent(&header_->mtx);
+            header_->peer_dead = true;
+            CloseLocked();
+            return 0;
+        }
+        return rc;
+    }
+
+    void Unlock() {
+        pthread_mutex_unlock(&header_->mtx);
+    }
+
+    void PushLocked(const T& value) {
+        std::memcpy(slots_ + (header_->tail & header_->mask) * sizeof(T), &value, sizeof(T));
+        ++header_->tail;
+        Wake(header_->recv_seq, header_->recv_waiters, 1);
+    }
+
+    void PopLocked(T& out) {
+        std::memcpy(&out, slots_ + (header_->head & header_->mask) * sizeof(T), sizeof(T));
+        ++header_->head;
+        Wake(header_->send_seq, header_->send_waiters, 1);
+    }
+
+    void CloseLocked() {
+        header_->closed = true;
+        Wake(header_->send_seq, header_->send_waiters, INT_MAX);
+        Wake(header_->recv_seq, header_->recv_waiters, INT_MAX);
+    }
+
+    // Счетчик ждущих меняется под мьютексом, поэтому без ждущих нет и syscall
+    void Wake(std::atomic<uint32_t>& seq, uint32_t waiters, int count) {
+        if (waiters > 0) {
+            seq.fetch_add(1, std::memory_order_release);
+            FutexWake(&seq, count, true);
+        }
+    }
+
+    // Один цикл ожидания: отпускает мьютекс, спит до пробуждения или
+    // kPeerCheckInterval, после таймаута проверяет живость соседей
+    void WaitLocked(std::atomic<uint32_t>& seq, uint32_t& waiters) {
+        if (!AttachLocked()) {
+            Unlock();
+            throw TooManyPeers();
+        }
+        uint32_t key = seq.load(std::memory_order_relaxed);
+        ++waiters;
+        Unlock();
+        bool woken = FutexWaitUntil(&seq, key, std::chrono::steady_clock::now() + kPeerCheckInterval, true);
+        Lock();
+        --waiters;
+        if (!woken && !header_->closed && PeerLost()) {
+            header_->peer_dead = true;
+            CloseLocked();
+        }
+    }
+
+    // false - свободных мест нет, процесс не зарегистрирован
+    bool AttachLocked() {
+        pid_t self = getpid();
+        if (attached_pid_ == self) {
+            return true;
+        }
+        for (pid_t& peer : header_->peers) {
+            if (peer == 0) {
+                peer = self;
+                attached_pid_ = self;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Detach() {
+        for (pid_t& peer : header_->peers) {
+            if (peer == attached_pid_) {
+                peer = 0;
+            }
+        }
+        attached_pid_ = 0;
+    }
+
+    // Зомби (умер, но родитель еще не вызвал waitpid) считается мертвым:
+    // иначе родитель, ждущий в канале, никогда не заметил бы смерть потомка
+    static bool ProcessAlive(pid_t pid) {
+        if (kill(pid, 0) == -1 && errno != EPERM) {
+            return false;
+        }
+        std::string path = "/proc/" + std::to_string(pid) + "/stat";
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            return true;
+        }
+        char buf[256];
+        ssize_t len = read(fd, buf, sizeof(buf) - 1);
+        close(fd);
+        if (len <= 0) {
+            return true;
+        }
+        buf[len] = '\0';
+        // Формат: pid (comm) state ...; comm может содержать скобки
+        const char* paren = std::strrchr(buf, ')');
+        if (!paren || paren[1] == '\0' || paren[2] == '\0') {
+            return true;
+        }
+        char state = paren[2];
+        return state != 'Z' && state != 'X';
+    }
+
+    // true - кто-то из соседей умер и живых соседей не осталось.
+    // Повторное использование pid ядром возможно, но за время ожидания маловероятно
+    bool PeerLost() {
+        pid_t self = getpid();
+        int alive = 0;
+        for (pid_t& peer : header_->peers) {
+            if (peer == 0 || peer == self) {
+                continue;
+            }
+            if (ProcessAlive(peer)) {
+                ++alive;
+            } else {
+                peer = 0;
+                ++header_->peers_died;
+            }
+        }
+        return alive == 0 && header_->peers_died > 0;
+    }
+
+    int fd_;
+    std::size_t size_ = 0;
+    Header* header_ = nullptr;
+    unsigned char* slots_ = nullptr;
+    pid_t attached_pid_ = 0;
+    pid_t creator_pid_ = 0;  // только этот процесс удаляет name_
+    std::string name_;
+};
+
+#endif // SHM_CHANNEL_H_
@@ -0,0 +1,270 @@
+#ifndef SPSC_CHANNEL_H_
+#define SPSC_CHANNEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "channel_status.h"
+#include "ring_buffer.h"
+
+// Канал ровно для одного отправителя и одного получателя с тем же API,
+// что у BufferedChannel. Быстрый путь без блокировок: отправитель пишет только
+// tail_, получатель только head_, каждый держит кэшированную копию чужого
+// индекса и перечитывает ее лишь когда канал кажется полным/пустым.
+// Мьютекс и условные переменные используются только для ожидания.
+template<class T>
+class SpscChannel {
+public:
+    explicit SpscChannel(int size)
+        : capacity_(CheckedCapacity(size, "SpscChannel")),
+          mask_(RoundUpPow2(capacity_) - 1),
+          slots_(new Slot[mask_ + 1]) {}
+
+    ~SpscChannel() {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        for (std::size_t i = head_.load(std::memory_order_relaxed); i != tail; ++i) {
+            Item(i)->~T();
+        }
+    }
+
+    SpscChannel(const SpscChannel&) = delete;
+    SpscChannel& operator=(const SpscChannel&) = delete;
+
+    void Send(T value) {
+        if (closed_.load(std::memory_order_acquire)) {
+            throw std::runtime_error("Channel is closed");
+        }
+
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ >= capacity_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ >= capacity_) {
+                WaitForSpace(tail);
+            }
+        }
+
+        new (slots_[tail & mask_].data) T(std::move(value));
+        tail_.store(tail + 1, std::memory_order_release);
+
+        WakeIfWaiting(recv_waiting_, recv_cv_);
+    }
+
+    std::pair<T, bool> Recv() {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_ && !WaitForItem(head)) {
+                return {T(), false};
+            }
+        }
+
+        T* item = Item(head);
+        T value = std::move(*item);
+        item->~T();
+        head_.store(head + 1, std::memory_order_release);
+
+        WakeIfWaiting(send_waiting_, send_cv_);
+        return {std::move(value), true};
+    }
+
+    // Неблокирующие версии: kOk, kFull/kEmpty или kClosed;
+    // value перемещается только при kOk
+    ChannelStatus TrySend(T&& value) {
+        if (closed_.load(std::memory_order_acquire)) {
+            return ChannelStatus::kClosed;
+        }
+
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ >= capacity_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ >= capacity_) {
+                return ChannelStatus::kFull;
+            }
+        }
+
+        new (slots_[tail & mask_].data) T(std::move(value));
+        tail_.store(tail + 1, std::memory_order_release);
+
+        WakeIfWaiting(recv_waiting_, recv_cv_);
+        return ChannelStatus::kOk;
+    }
+
+    ChannelStatus TrySend(const T& value) {
+        T copy(value);
+        return TrySend(std::move(copy));
+    }
+
+    ChannelStatus TryRecv(T& out) {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            // closed_ читается раньше tail_: все отправленное до Close() уже видно
+            bool closed = closed_.load(std::memory_order_acquire);
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return closed ? ChannelStatus::kClosed : ChannelStatus::kEmpty;
+            }
+        }
+        PopAvailable(head, 1, [&out](std::size_t, T&& value) {
+            out = std::move(value);
+        });
+        return ChannelStatus::kOk;
+    }
+
+    // Пакетные версии: одна публикация индекса и одно пробуждение на порцию
+    template<class InputIt>
+    void SendMany(InputIt first, InputIt last) {
+        while (first != last) {
+            if (closed_.load(std::memory_order_acquire)) {
+                throw std::runtime_error("Channel is closed");
+            }
+
+            std::size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - cached_head_ >= capacity_) {
+                cached_head_ = head_.load(std::memory_order_acquire);
+                if (tail - cached_head_ >= capacity_) {
+                    WaitForSpace(tail);
+                }
+            }
+
+            std::size_t end = cached_head_ + capacity_;
+            std::size_t pos = tail;
+            for (; first != last && pos != end; ++first, ++pos) {
+                new (slots_[pos & mask_].data) T(std::move(*first));
+            }
+            tail_.store(pos, std::memory_order_release);
+
+            WakeIfWaiting(recv_waiting_, recv_cv_);
+        }
+    }
+
+    // Ждет хотя бы один элемент и забирает до out.size(); 0 - закрыт и пуст.
+    // Пустой out - std::invalid_argument, как у BufferedChannel
+    std::size_t RecvMany(std::span<T> out) {
+        if (out.empty()) {
+            throw std::invalid_argument("RecvMany needs a non-empty buffer");
+        }
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_ && !WaitForItem(head)) {
+                return 0;
+            }
+        }
+        return PopAvailable(head, out.size(), [&out](std::size_t i, T&& value) {
+            out[i] = std::move(value);
+        });
+    }
+
+    // Забирает все, что уже опубликовано, не блокируясь
+    std::size_t DrainAll(std::vector<T>& out) {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        out.reserve(out.size() + (cached_tail_ - head));
+        return PopAvailable(head, cached_tail_ - head, [&out](std::size_t, T&& value) {
+            out.push_back(std::move(value));
+        });
+    }
+
+    void Close() {
+        closed_.store(true, std::memory_order_release);
+
+        std::unique_lock<std::mutex> lock(mtx_);
+        send_cv_.notify_all();
+        recv_cv_.notify_all();
+    }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    T* Item(std::size_t index) {
+        return std::launder(reinterpret_cast<T*>(slots_[index & mask_].data));
+    }
+
+    // Извлекает до limit элементов из [head, cached_tail_) одной публикацией head_
+    template<class Sink>
+    std::size_t PopAvailable(std::size_t head, std::size_t limit, Sink sink) {
+        std::size_t count = std::min(limit, cached_tail_ - head);
+        for (std::size_t i = 0; i < count; ++i) {
+            T* item = Item(head + i);
+            sink(i, std::move(*item));
+            item->~T();
+        }
+        if (count > 0) {
+            head_.store(head + count, std::memory_order_release);
+            WakeIfWaiting(send_waiting_, send_cv_);
+        }
+        return count;
+    }
+
+    // Ожидающая сторона выставляет флаг и перепроверяет индекс под мьютексом,
+    // публикующая сторона после store ставит seq_cst барьер и читает флаг:
+    // хотя бы одна из них увидит запись другой, так что пробуждение не теряется,
+    // а если никто не ждет, notify не вызывается вовсе
+    void WakeIfWaiting(std::atomic<bool>& waiting, std::condition_variable& cv) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(mtx_);
+            cv.notify_one();
+        }
+    }
+
+    void WaitForSpace(std::size_t tail) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        send_waiting_.store(true, std::memory_order_seq_cst);
+        send_cv_.wait(lock, [this, tail]() {
+            cached_head_ = head_.load(std::memory_order_seq_cst);
+            return tail - cached_head_ < capacity_ || closed_.load();
+        });
+        send_waiting_.store(false, std::memory_order_relaxed);
+
+        if (closed_.load()) {
+            throw std::runtime_error("Channel is closed");
+        }
+    }
+
+    // false, если канал закрыт и пуст
+    bool WaitForItem(std::size_t head) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        recv_waiting_.store(true, std::memory_order_seq_cst);
+        recv_cv_.wait(lock, [this, head]() {
+            cached_tail_ = tail_.load(std::memory_order_seq_cst);
+            return head != cached_tail_ || closed_.load();
+        });
+        recv_waiting_.store(false, std::memory_order_relaxed);
+
+        return head != cached_tail_;
+    }
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    // Линия получателя
+    alignas(kCacheLineSize) std::atomic<std::size_t> head_{0};
+    std::size_t cached_tail_ = 0;
+
+    // Линия отправителя
+    alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0};
+    std::size_t cached_head_ = 0;
+
+    // Медленный путь
+    alignas(kCacheLineSize) std::atomic<bool> closed_{false};
+    std::atomic<bool> send_waiting_{false};
+    std::atomic<bool> recv_waiting_{false};
+    std::mutex mtx_;
+    std::condition_variable send_cv_;
+    std::condition_variable recv_cv_;
+};
+
+#endif // SPSC_CHANNEL_H_
@@ -0,0 +1,491 @@
+#ifndef STREAM_H_
+#define STREAM_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "buhhered_channel.h"
+
+// Конвейер потоковой обработки из стадий, соединенных ограниченными каналами:
+//
+//   Pipeline pipeline(64);
+//   pipeline.Source<int>("numbers", gen)
+//       .Map("square", f, 4)
+//       .Filter("even", pred)
+//       .Sink("print", g);
+//   pipeline.Wait();
+//
+// Обратное давление: каждая стадия блокируется на Send, пока следующая не
+// разберет канал, так что в полете не больше емкости каналов.
+// Закрытие: источник закончился - каждая стадия дорабатывает вход и закрывает
+// выход. Стадия ниже закрыла вход (или Cancel) - Send верхней стадии
+// возвращает kClosed, и та закрывает свой вход, передавая остановку вверх.
+// Исключение из функции стадии отменяет весь конвейер; Wait() его пробрасывает.
+// Каждый Stream можно использовать как вход только для одной стадии.
+
+// Порядок результатов параллельного Map
+enum class MapOrder {
+    kOrdered,    // в порядке входа (буфер переупорядочивания ограничен окном)
+    kUnordered,  // по мере готовности
+};
+
+struct StageStats {
+    std::string name;
+    int workers = 0;  // потоки, вызывающие функцию стадии
+    int threads = 0;  // все потоки стадии; у Map с порядком еще раздатчик и сборщик
+    uint64_t items_in = 0;
+    uint64_t items_out = 0;
+    std::chrono::nanoseconds busy{0};  // время внутри функции стадии, сумма по потокам
+    std::chrono::nanoseconds wall{0};  // от запуска стадии до закрытия ее выхода
+    bool finished = false;
+
+    double ItemsPerSecond() const {
+        return wall.count() > 0 ? items_out * 1e9 / wall.count() : 0.0;
+    }
+
+    // Доля времени, которую рабочие потоки (workers) считали, а не ждали каналы
+    double Utilization() const {
+        return wall.count() > 0 && workers > 0
+            ? static_cast<double>(busy.count()) / (static_cast<double>(wall.count()) * workers)
+            : 0.0;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const StageStats& stats) {
+    out << stats.name << " x" << stats.workers;
+    if (stats.threads != stats.workers) {
+        out << " (" << stats.threads << " threads)";
+    }
+    return out << " in " << stats.items_in
+               << " out " << stats.items_out
+               << " items/s " << static_cast<long long>(stats.ItemsPerSecond())
+               << " busy " << static_cast<int>(stats.Utilization() * 100) << "%"
+               << (stats.finished ? "" : " (running)");
+}
+
+class Pipeline;
+
+template<class T>
+class Stream {
+public:
+    template<class F>
+    using MapResult = std::decay_t<std::invoke_result_t<F&, T>>;
+
+    // f(T) -> U на parallelism потоках
+    template<class F>
+    Stream<MapResult<F>> Map(std::string name, F f, int parallelism = 1,
+                             MapOrder order = MapOrder::kOrdered);
+
+    template<class Pred>
+    Stream<T> Filter(std::string name, Pred pred);
+
+    // Порции по size элементов; последняя может быть короче
+    Stream<std::vector<T>> Batch(std::string name, std::size_t size);
+
+    // Свертка по ключу: acc = fold(acc, item), начиная с init. Пары (ключ, итог)
+    // выдаются в порядке ключей, когда вход закончился
+    template<class KeyFn, class V, class Fold>
+    Stream<std::pair<std::decay_t<std::invoke_result_t<KeyFn&, const T&>>, V>>
+    ReduceByKey(std::string name, KeyFn key, V init, Fold fold);
+
+    template<class F>
+    void Sink(std::string name, F f);
+
+private:
+    friend class Pipeline;
+    template<class U> friend class Stream;
+
+    Stream(Pipeline* pipeline, std::shared_ptr<BufferedChannel<T>> channel)
+        : pipeline_(pipeline), channel_(std::move(channel)) {}
+
+    Pipeline* pipeline_;
+    std::shared_ptr<BufferedChannel<T>> channel_;
+};
+
+class Pipeline {
+public:
+    // capacity - емкость каждого канала между стадиями
+    explicit Pipeline(int capacity = 64) : capacity_(capacity > 0 ? capacity : 1) {}
+
+    ~Pipeline() {
+        if (!threads_.empty()) {
+            Cancel();
+            Join();
+        }
+    }
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    // gen() -> std::optional<T>; nullopt - конец потока
+    template<class T, class Gen>
+    Stream<T> Source(std::string name, Gen gen) {
+        auto out = MakeChannel<T>();
+        Stage& stage = AddStage(std::move(name), 1);
+        Spawn(stage, 1, [out, gen, &stage]() mutable {
+            while (true) {
+                auto start = Clock::now();
+                std::optional<T> item = gen();
+                stage.AddBusy(start);
+                if (!item || out->SendNoThrow(std::move(*item)) == ChannelStatus::kClosed) {
+                    break;
+                }
+                stage.items_out.fetch_add(1, std::memory_order_relaxed);
+            }
+        }, [out]() { out->Close(); });
+        return Stream<T>(this, out);
+    }
+
+    // Дождаться всех стадий; пробрасывает первое исключение из функций стадий
+    void Wait() {
+        Join();
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+
+    // Закрыть все каналы: стадии завершаются, не дорабатывая вход
+    void Cancel() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        for (auto& close : closers_) {
+            close();
+        }
+    }
+
+    std::vector<StageStats> Stats() const {
+        std::vector<StageStats> result;
+        std::unique_lock<std::mutex> lock(mtx_);
+        for (const auto& stage : stages_) {
+            result.push_back(stage->Snapshot());
+        }
+        return result;
+    }
+
+private:
+    template<class T> friend class Stream;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Stage {
+        Stage(std::string stage_name, int stage_workers)
+            : name(std::move(stage_name)), workers(stage_workers), start(Clock::now()) {}
+
+        void AddBusy(Clock::time_point since) {
+            busy_ns.fetch_add((Clock::now() - since).count(), std::memory_order_relaxed);
+        }
+
+        StageStats Snapshot() const {
+            StageStats stats;
+            stats.name = name;
+            stats.workers = workers;
+            stats.threads = threads.load(std::memory_order_relaxed);
+            stats.items_in = items_in.load(std::memory_order_relaxed);
+            stats.items_out = items_out.load(std::memory_order_relaxed);
+            stats.busy = std::chrono::nanoseconds(busy_ns.load(std::memory_order_relaxed));
+            int64_t finish = finish_ns.load(std::memory_order_acquire);
+            stats.finished = finish != 0;
+            stats.wall = stats.finished
+                ? std::chrono::nanoseconds(finish)
+                : std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+            return stats;
+        }
+
+        void Finish() {
+            int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - start).count();
+            // 0 значит "еще работает"
+            finish_ns.store(elapsed > 0 ? elapsed : 1, std::memory_order_release);
+        }
+
+        const std::string name;
+        const int workers;
+        const Clock::time_point start;
+        std::atomic<int> threads{0};
+        std::atomic<uint64_t> items_in{0};
+        std::atomic<uint64_t> items_out{0};
+        std::atomic<int64_t> busy_ns{0};
+        std::atomic<int64_t> finish_ns{0};
+    };
+
+    template<class T>
+    std::shared_ptr<BufferedChannel<T>> MakeChannel(int capacity = 0) {
+        auto channel = std::make_shared<BufferedChannel<T>>(capacity > 0 ? capacity : capacity_);
+        std::unique_lock<std::mutex> lock(mtx_);
+        closers_.push_back([channel]() { channel->Close(); });
+        return channel;
+    }
+
+    Stage& AddStage(std::string name, int workers) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        stages_.push_back(std::make_unique<Stage>(std::move(name), workers));
+        return *stages_.back();
+    }
+
+    // count потоков выполняют body; последний завершившийся вызывает on_last.
+    // last_group - эта группа закрывает выход стадии, фиксируем время
+    template<class Body, class OnLast>
+    void Spawn(Stage& stage, int count, Body body, OnLast on_last, bool last_group = true) {
+        auto running = std::make_shared<std::atomic<int>>(count);
+        stage.threads.fetch_add(count, std::memory_order_relaxed);
+        for (int i = 0; i < count; ++i) {
+            threads_.emplace_back([this, &stage, running, body, on_last, last_group]() mutable {
+                try {
+                    body();
+                } catch (...) {
+                    Fail(std::current_exception());
+                }
+                if (running->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    on_last();
+                    if (last_group) {
+                        stage.Finish();
+                    }
+                }
+            });
+        }
+    }
+
+    void Fail(std::exception_ptr error) {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            if (!error_) {
+                error_ = error;
+            }
+        }
+        Cancel();
+    }
+
+    void Join() {
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+        threads_.clear();
+    }
+
+    const int capacity_;
+    mutable std::mutex mtx_;
+    std::vector<std::function<void()>> closers_;
+    std::deque<std::unique_ptr<Stage>> stages_;
+    std::vector<std::thread> threads_;
+    std::exception_ptr error_;
+};
+
+template<class T>
+template<class F>
+Stream<typename Stream<T>::template MapResult<F>>
+Stream<T>::Map(std::string name, F f, int parallelism, MapOrder order) {
+    using U = MapResult<F>;
+    using Clock = Pipeline::Clock;
+    if (parallelism < 1) {
+        parallelism = 1;
+    }
+    auto in = channel_;
+    auto out = pipeline_->template MakeChannel<U>();
+    Pipeline::Stage& stage = pipeline_->AddStage(std::move(name), parallelism);
+
+    if (parallelism == 1 || order == MapOrder::kUnordered) {
+        // Каждый поток читает вход и пишет в выход сам; выход закрывает последний
+        pipeline_->Spawn(stage, parallelism, [in, out, f, &stage]() mutable {
+            T item;
+            while (in->RecvInto(item)) {
+                stage.items_in.fetch_add(1, std::memory_order_relaxed);
+                auto start = Clock::now();
+                U result = f(std::move(item));
+                stage.AddBusy(start);
+                if (out->SendNoThrow(std::move(result)) == ChannelStatus::kClosed) {
+                    in->Close();
+                    break;
+                }
+                stage.items_out.fetch_add(1, std::memory_order_relaxed);
+            }
+        }, [out]() { out->Close(); });
+        return Stream<U>(pipeline_, out);
+    }
+
+    // С сохранением порядка: раздатчик нумерует элементы, потоки считают,
+    // сборщик выдает по номерам. Окно - канал-семафор: раздатчик берет жетон
+    // на каждый элемент, сборщик возвращает при выдаче, так что буфер
+    // переупорядочивания не больше окна даже при одном медленном элементе
+    int window_size = pipeline_->capacity_ + parallelism;
+    auto window = pipeline_->template MakeChannel<char>(window_size);
+    auto work = pipeline_->template MakeChannel<std::pair<uint64_t, T>>();
+    auto done = pipeline_->template MakeChannel<std::pair<uint64_t, U>>();
+
+    pipeline_->Spawn(stage, 1, [in, window, work, &stage]() {
+        uint64_t seq = 0;
+        T item;
+        while (in->RecvInto(item)) {
+            stage.items_in.fetch_add(1, std::memory_order_relaxed);
+            if (window->SendNoThrow(0) == ChannelStatus::kClosed ||
+                work->SendNoThrow({seq++, std::move(item)}) == ChannelStatus::kClosed) {
+                in->Close();
+                break;
+            }
+        }
+    }, [work]() { work->Close(); }, false);
+
+    pipeline_->Spawn(stage, parallelism, [work, done, f, &stage]() mutable {
+        std::pair<uint64_t, T> job;
+        while (work->RecvInto(job)) {
+            auto start = Clock::now();
+            U result = f(std::move(job.second));
+            stage.AddBusy(start);
+            if (done->SendNoThrow({job.first, std::move(result)}) == ChannelStatus::kClosed) {
+                work->Close();
+                break;
+            }
+        }
+    }, [done]() { done->Close(); }, false);
+
+    pipeline_->Spawn(stage, 1, [done, window, out, &stage]() {
+        std::map<uint64_t, U> pending;
+        uint64_t next = 0;
+        std::pair<uint64_t, U> result;
+        while (done->RecvInto(result)) {
+            pending.emplace(result.first, std::move(result.second));
+            for (auto it = pending.begin(); it != pending.end() && it->first == next;
+                 it = pending.erase(it), ++next) {
+                if (out->SendNoThrow(std::move(it->second)) == ChannelStatus::kClosed) {
+                    // Вниз больше некуда: останавливаем раздатчик и потоки
+                    window->Close();
+                    done->Close();
+                    return;
+                }
+                stage.items_out.fetch_add(1, std::memory_order_relaxed);
+                char token;
+                window->TryRecv(token);
+            }
+        }
+    }, [out]() { out->Close(); });
+
+    return Stream<U>(pipeline_, out);
+}
+
+template<class T>
+template<class Pred>
+Stream<T> Stream<T>::Filter(std::string name, Pred pred) {
+    using Clock = Pipeline::Clock;
+    auto in = channel_;
+    auto out = pipeline_->template MakeChannel<T>();
+    Pipeline::Stage& stage = pipeline_->AddStage(std::move(name), 1);
+
+    pipeline_->Spawn(stage, 1, [in, out, pred, &stage]() mutable {
+        T item;
+        while (in->RecvInto(item)) {
+            stage.items_in.fetch_add(1, std::memory_order_relaxed);
+            auto start = Clock::now();
+            bool keep = pred(static_cast<const T&>(item));
+            stage.AddBusy(start);
+            if (!keep) {
+                continue;
+            }
+            if (out->SendNoThrow(std::move(item)) == ChannelStatus::kClosed) {
+                in->Close();
+                break;
+            }
+            stage.items_out.fetch_add(1, std::memory_order_relaxed);
+        }
+    }, [out]() { out->Close(); });
+    return Stream<T>(pipeline_, out);
+}
+
+template<class T>
+Stream<std::vector<T>> Stream<T>::Batch(std::string name, std::size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    auto in = channel_;
+    auto out = pipeline_->template MakeChannel<std::vector<T>>();
+    Pipeline::Stage& stage = pipeline_->AddStage(std::move(name), 1);
+
+    pipeline_->Spawn(stage, 1, [in, out, size, &stage]() {
+        std::vector<T> batch;
+        batch.reserve(size);
+        T item;
+        bool open = true;
+        while (open) {
+            open = in->RecvInto(item);
+            if (open) {
+                stage.items_in.fetch_add(1, std::memory_order_relaxed);
+                batch.push_back(std::move(item));
+            }
+            // Полная порция или хвост после закрытия входа
+            if (batch.size() == size || (!open && !batch.empty())) {
+                if (out->SendNoThrow(std::move(batch)) == ChannelStatus::kClosed) {
+                    in->Close();
+                    break;
+                }
+                stage.items_out.fetch_add(1, std::memory_order_relaxed);
+                batch = std::vector<T>();
+                batch.reserve(size);
+            }
+        }
+    }, [out]() { out->Close(); });
+    return Stream<std::vector<T>>(pipeline_, out);
+}
+
+template<class T>
+template<class KeyFn, class V, class Fold>
+Stream<std::pair<std::decay_t<std::invoke_result_t<KeyFn&, const T&>>, V>>
+Stream<T>::ReduceByKey(std::string name, KeyFn key, V init, Fold fold) {
+    using K = std::decay_t<std::invoke_result_t<KeyFn&, const T&>>;
+    using Clock = Pipeline::Clock;
+    auto in = channel_;
+    auto out = pipeline_->template MakeChannel<std::pair<K, V>>();
+    Pipeline::Stage& stage = pipeline_->AddStage(std::move(name), 1);
+
+    pipeline_->Spawn(stage, 1, [in, out, key, init, fold, &stage]() mutable {
+        std::map<K, V> totals;
+        T item;
+        while (in->RecvInto(item)) {
+            stage.items_in.fetch_add(1, std::memory_order_relaxed);
+            auto start = Clock::now();
+            auto it = totals.try_emplace(key(static_cast<const T&>(item)), init).first;
+            it->second = fold(std::move(it->second), std::move(item));
+            stage.AddBusy(start);
+        }
+        for (auto& [k, total] : totals) {
+            if (out->SendNoThrow(std::pair<K, V>(k, std::move(total))) == ChannelStatus::kClosed) {
+                break;
+            }
+            stage.items_out.fetch_add(1, std::memory_order_relaxed);
+        }
+    }, [out]() { out->Close(); });
+    return Stream<std::pair<K, V>>(pipeline_, out);
+}
+
+template<class T>
+template<class F>
+void Stream<T>::Sink(std::string name, F f) {
+    using Clock = Pipeline::Clock;
+    auto in = channel_;
+    Pipeline::Stage& stage = pipeline_->AddStage(std::move(name), 1);
+
+    pipeline_->Spawn(stage, 1, [in, f, &stage]() mutable {
+        T item;
+        while (in->RecvInto(item)) {
+            stage.items_in.fetch_add(1, std::memory_order_relaxed);
+            auto start = Clock::now();
+            f(std::move(item));
+            stage.AddBusy(start);
+            stage.items_out.fetch_add(1, std::memory_order_relaxed);
+        }
+    }, [in]() { in->Close(); });
+}
+
+#endif // STREAM_H_
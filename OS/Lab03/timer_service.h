@@ -0,0 +1,485 @@
+#ifndef TIMER_SERVICE_H_
+#define TIMER_SERVICE_H_
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "buhhered_channel.h"
+
+// Идентификатор таймера для Cancel. generation защищает от отмены чужого
+// таймера, занявшего тот же слот после срабатывания
+struct TimerId {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+};
+
+// Срабатывание таймера, поставленного через AfterInto/TickerInto
+struct TimerEvent {
+    uint64_t tag = 0;
+    TimerId id;
+    std::chrono::steady_clock::time_point deadline;
+};
+
+// Таймеры на иерархическом колесе, один поток на все.
+// Вставка и отмена - O(1): узел в двусвязном списке слота. Узлы лежат в
+// одном векторе со списком свободных, так что AfterInto/TickerInto не
+// выделяют память (кроме роста вектора до пикового числа таймеров).
+// After/Ticker выделяют: make_shared и буфер своего канала на каждый таймер.
+// Точность - один тик (по умолчанию 1 мс). Поток колеса просыпается не на
+// каждом тике, а к ближайшему непустому слоту или к перекладке верхнего уровня.
+//
+// Ближний уровень - 512 слотов по тику: текущий блок из 256 тиков и следующий.
+// Верхние уровни - по 256 слотов на блок, на 256 блоков и т.д. (до 2^32 тиков;
+// дальние таймеры перекладываются, пока не окажутся в пределах колеса).
+// Слот первого уровня для следующего блока переносится в ближний уровень
+// понемногу на каждом тике текущего блока, а не разом на границе: иначе
+// с миллионом таймеров граница блока стоила бы десятки миллисекунд опоздания.
+//
+// Доставка - в BufferedChannel и никогда не блокирует поток колеса:
+//  - After/Ticker - свой канал емкостью 1, как time.After/time.Ticker в Go;
+//    тик, который получатель не успел забрать, пропадает;
+//  - AfterInto/TickerInto - общий канал событий для многих таймеров;
+//    сработавшие на одном тике уходят в него одной порцией (TrySendMany).
+//    Не поместившиеся события отбрасываются и считаются в Dropped(),
+//    поэтому емкость такого канала нужно выбирать с запасом.
+class TimerService {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimeChannel = BufferedChannel<Clock::time_point>;
+    using EventChannel = BufferedChannel<TimerEvent>;
+
+    struct Timer {
+        TimerId id;
+        std::shared_ptr<TimeChannel> channel;
+    };
+
+    explicit TimerService(std::chrono::nanoseconds tick = std::chrono::milliseconds(1))
+        : tick_(tick.count() > 0 ? tick : std::chrono::nanoseconds(1)),
+          start_(Clock::now()),
+          thread_([this]() { Run(); }) {}
+
+    ~TimerService() {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+    }
+
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    // Канал получит время срабатывания один раз
+    template<class Rep, class Period>
+    Timer After(std::chrono::duration<Rep, Period> delay) {
+        auto channel = std::make_shared<TimeChannel>(1);
+        TimerId id = Add(Clock::now() + delay, Clock::duration::zero(), channel, nullptr, 0);
+        return {id, std::move(channel)};
+    }
+
+    // Канал получает время каждого тика, пока таймер не отменят
+    template<class Rep, class Period>
+    Timer Ticker(std::chrono::duration<Rep, Period> period) {
+        auto channel = std::make_shared<TimeChannel>(1);
+        TimerId id = Add(Clock::now() + period, period, channel, nullptr, 0);
+        return {id, std::move(channel)};
+    }
+
+    template<class Rep, class Period>
+    TimerId AfterInto(std::chrono::duration<Rep, Period> delay,
+                      std::shared_ptr<EventChannel> sink, uint64_t tag) {
+        return Add(Clock::now() + delay, Clock::duration::zero(), nullptr, std::move(sink), tag);
+    }
+
+    template<class Rep, class Period>
+    TimerId TickerInto(std::chrono::duration<Rep, Period> period,
+                       std::shared_ptr<EventChannel> sink, uint64_t tag) {
+        return Add(Clock::now() + period, period, nullptr, std::move(sink), tag);
+    }
+
+    // false - таймер уже сработал (разовый) или отменен
+    bool Cancel(TimerId id) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (id.index >= nodes_.size() || nodes_[id.index].generation != id.generation ||
+            !nodes_[id.index].armed) {
+            return false;
+        }
+        UnlinkLocked(id.index);
+        FreeLocked(id.index);
+        return true;
+    }
+
+    std::size_t Active() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        return active_;
+    }
+
+    uint64_t Fired() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        return fired_;
+    }
+
+    // Срабатывания, не поместившиеся в канал (тики After/Ticker не считаются)
+    uint64_t Dropped() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        return dropped_;
+    }
+
+private:
+    static constexpr int kLevels = 4;  // ближний и три верхних
+    static constexpr int kSlotBits = 8;
+    static constexpr uint32_t kSlots = 1u << kSlotBits;
+    static constexpr uint32_t kSlotMask = kSlots - 1;
+    static constexpr uint32_t kNearSlots = 2 * kSlots;
+    static constexpr uint32_t kNearMask = kNearSlots - 1;
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    struct Slot {
+        uint32_t head = kNil;
+        uint32_t count = 0;
+    };
+
+    struct Node {
+        uint64_t expires = 0;  // тик
+        Clock::duration period{0};
+        Clock::time_point deadline;
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        Slot* slot = nullptr;  // слот, в списке которого лежит узел
+        uint32_t generation = 0;
+        bool armed = false;
+        uint64_t tag = 0;
+        std::shared_ptr<TimeChannel> channel;
+        std::shared_ptr<EventChannel> sink;
+    };
+
+    // Сработавший таймер, собранный под мьютексом для доставки без него.
+    // Ссылки держат канал живым, даже если таймер успели отменить
+    struct Expired {
+        TimerEvent event;
+        std::shared_ptr<TimeChannel> channel;
+        std::shared_ptr<EventChannel> sink;
+    };
+
+    template<class Rep, class Period>
+    static Clock::duration PeriodOf(std::chrono::duration<Rep, Period> period) {
+        auto result = std::chrono::duration_cast<Clock::duration>(period);
+        return result.count() > 0 ? result : Clock::duration(1);
+    }
+
+    template<class Rep, class Period>
+    TimerId Add(Clock::time_point deadline, std::chrono::duration<Rep, Period> period,
+                std::shared_ptr<TimeChannel> channel, std::shared_ptr<EventChannel> sink,
+                uint64_t tag) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        uint32_t index = AllocLocked();
+        Node& node = nodes_[index];
+        node.deadline = deadline;
+        node.period = period.count() > 0 ? PeriodOf(period) : Clock::duration::zero();
+        node.tag = tag;
+        node.channel = std::move(channel);
+        node.sink = std::move(sink);
+        node.expires = TickAt(deadline);
+
+        // Будим поток колеса, только если таймеру нужен тик раньше того,
+        // до которого он спит (без таймеров он спит до первой вставки)
+        if (LinkLocked(index) < wake_tick_) {
+            cv_.notify_one();
+        }
+        return {index, node.generation};
+    }
+
+    // Первый тик не раньше deadline
+    uint64_t TickAt(Clock::time_point deadline) const {
+        auto since = deadline - start_;
+        if (since.count() <= 0) {
+            return 0;
+        }
+        auto ticks = (std::chrono::duration_cast<std::chrono::nanoseconds>(since) + tick_ -
+                      std::chrono::nanoseconds(1)) / tick_;
+        return static_cast<uint64_t>(ticks);
+    }
+
+    uint64_t NowTick() const {
+        return static_cast<uint64_t>((Clock::now() - start_) / tick_);
+    }
+
+    Clock::time_point TimeOfTick(uint64_t tick) const {
+        return start_ + std::chrono::duration_cast<Clock::duration>(tick_) * static_cast<int64_t>(tick);
+    }
+
+    uint32_t AllocLocked() {
+        uint32_t index;
+        if (free_ != kNil) {
+            index = free_;
+            free_ = nodes_[index].next;
+        } else {
+            index = static_cast<uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        }
+        nodes_[index].armed = true;
+        ++active_;
+        return index;
+    }
+
+    void FreeLocked(uint32_t index) {
+        Node& node = nodes_[index];
+        node.armed = false;
+        ++node.generation;
+        node.channel.reset();
+        node.sink.reset();
+        node.next = free_;
+        free_ = index;
+        --active_;
+    }
+
+    // Ближний уровень - если срок в текущем или следующем блоке. Иначе
+    // самый низкий верхний уровень, где блок срока и следующий блок совпадают
+    // в старших разрядах. Слот узла переложат вниз до наступления его блока.
+    // Возвращает первый тик, на котором колесу придется заняться узлом
+    uint64_t LinkLocked(uint32_t index) {
+        Node& node = nodes_[index];
+        if (node.expires < current_) {
+            node.expires = current_;
+        }
+        uint64_t block = node.expires >> kSlotBits;
+        uint64_t next_block = (current_ >> kSlotBits) + 1;
+        Slot* slot;
+        uint64_t due;
+        if (block <= next_block) {
+            slot = &near_[node.expires & kNearMask];
+            due = node.expires;
+        } else {
+            int level = 1;
+            while (level < kLevels - 1 &&
+                   (block >> (level * kSlotBits)) != (next_block >> (level * kSlotBits))) {
+                ++level;
+            }
+            if ((block >> (level * kSlotBits)) != (next_block >> (level * kSlotBits))) {
+                // Дальше колеса: в последний слот верхнего уровня, при
+                // перекладке срок пересчитается по настоящему expires
+                block = next_block | ((uint64_t{1} << (level * kSlotBits)) - 1);
+            }
+            int shift = (level - 1) * kSlotBits;
+            slot = &far_[level - 1][(block >> shift) & kSlotMask];
+            // Слот спускается в начале блока перед первым блоком своей группы
+            due = (((block >> shift) << shift) - 1) << kSlotBits;
+        }
+
+        node.slot = slot;
+        node.prev = kNil;
+        node.next = slot->head;
+        if (slot->head != kNil) {
+            nodes_[slot->head].prev = index;
+        }
+        slot->head = index;
+        ++slot->count;
+        return due;
+    }
+
+    void UnlinkLocked(uint32_t index) {
+        Node& node = nodes_[index];
+        if (node.prev != kNil) {
+            nodes_[node.prev].next = node.next;
+        } else {
+            node.slot->head = node.next;
+        }
+        if (node.next != kNil) {
+            nodes_[node.next].prev = node.prev;
+        }
+        --node.slot->count;
+        node.prev = node.next = kNil;
+        node.slot = nullptr;
+    }
+
+    // Переложить до limit узлов слота верхнего уровня ниже
+    void CascadeLocked(Slot& slot, uint32_t limit) {
+        while (slot.head != kNil && limit-- > 0) {
+            uint32_t index = slot.head;
+            UnlinkLocked(index);
+            LinkLocked(index);
+        }
+    }
+
+    // Обработать тик current_ и перейти к следующему
+    void AdvanceLocked() {
+        uint64_t offset = current_ & kSlotMask;
+        uint64_t next_block = (current_ >> kSlotBits) + 1;
+
+        // В начале блока верхние уровни спускают то, что относится
+        // к следующему блоку, на первый уровень - сверху вниз
+        if (offset == 0) {
+            for (int level = kLevels - 1; level >= 2; --level) {
+                int shift = (level - 1) * kSlotBits;
+                if ((next_block & ((uint64_t{1} << shift) - 1)) == 0) {
+                    CascadeLocked(far_[level - 1][(next_block >> shift) & kSlotMask], UINT32_MAX);
+                }
+            }
+        }
+        // Слот следующего блока - равными долями до конца текущего
+        Slot& pending = far_[0][next_block & kSlotMask];
+        if (pending.count > 0) {
+            uint64_t ticks_left = kSlots - offset;
+            CascadeLocked(pending, static_cast<uint32_t>((pending.count + ticks_left - 1) / ticks_left));
+        }
+
+        Slot& slot = near_[current_ & kNearMask];
+        uint32_t index = slot.head;
+        slot.head = kNil;
+        slot.count = 0;
+        ++current_;
+
+        while (index != kNil) {
+            Node& node = nodes_[index];
+            uint32_t next = node.next;
+            node.slot = nullptr;
+            ++fired_;
+            TimerEvent event{node.tag, {index, node.generation}, node.deadline};
+            if (node.period.count() > 0) {
+                expired_.push_back(Expired{event, node.channel, node.sink});
+                // Пропущенные периоды не накапливаются: следующий срок - в будущем
+                node.deadline += node.period;
+                Clock::time_point now = TimeOfTick(current_);
+                if (node.deadline < now) {
+                    auto behind = (now - node.deadline) / node.period + 1;
+                    node.deadline += node.period * behind;
+                }
+                node.expires = TickAt(node.deadline);
+                LinkLocked(index);
+            } else {
+                expired_.push_back(Expired{event, std::move(node.channel), std::move(node.sink)});
+                FreeLocked(index);
+            }
+            index = next;
+        }
+    }
+
+    // Первый тик от current_, на котором AdvanceLocked есть что делать:
+    // непустой ближний слот, спуск верхнего уровня в начале блока или
+    // перенос слота следующего блока. Тики до него можно пропустить целиком.
+    // Ближние слоты смотрим только в двух блоках - дальше они повторяются и
+    // уже проверены пустыми; дальше проверяем лишь границы блоков, не больше kSlots
+    uint64_t NextWorkTickLocked() const {
+        uint64_t tick = current_;
+        for (uint32_t blocks = 0; blocks < kSlots; ++blocks) {
+            uint64_t next_block = (tick >> kSlotBits) + 1;
+            if ((tick & kSlotMask) == 0) {
+                for (int level = kLevels - 1; level >= 2; --level) {
+                    int shift = (level - 1) * kSlotBits;
+                    if ((next_block & ((uint64_t{1} << shift) - 1)) == 0 &&
+                        far_[level - 1][(next_block >> shift) & kSlotMask].count > 0) {
+                        return tick;
+                    }
+                }
+            }
+            if (far_[0][next_block & kSlotMask].count > 0) {
+                return tick;
+            }
+            uint64_t end = next_block << kSlotBits;
+            if (blocks < 2) {
+                for (; tick < end; ++tick) {
+                    if (near_[tick & kNearMask].count > 0) {
+                        return tick;
+                    }
+                }
+            }
+            tick = end;
+        }
+        return tick;
+    }
+
+    // Вне мьютекса колеса: доставка берет мьютексы каналов.
+    // Периодический таймер, отмененный между сбором и доставкой,
+    // успевает дать еще один тик
+    void Deliver(std::vector<Expired>& expired, std::vector<TimerEvent>& batch) {
+        uint64_t dropped = 0;
+        // Группируем по общему каналу, чтобы отправить каждому одной порцией
+        std::stable_sort(expired.begin(), expired.end(), [](const Expired& a, const Expired& b) {
+            return a.sink < b.sink;
+        });
+        for (std::size_t i = 0; i < expired.size();) {
+            if (!expired[i].sink) {
+                expired[i].channel->TrySend(expired[i].event.deadline);
+                ++i;
+                continue;
+            }
+            EventChannel* sink = expired[i].sink.get();
+            batch.clear();
+            for (; i < expired.size() && expired[i].sink.get() == sink; ++i) {
+                batch.push_back(expired[i].event);
+            }
+            dropped += batch.size() - sink->TrySendMany(batch.begin(), batch.end());
+        }
+        expired.clear();
+        if (dropped > 0) {
+            std::unique_lock<std::mutex> lock(mtx_);
+            dropped_ += dropped;
+        }
+    }
+
+    void Run() {
+        std::vector<Expired> expired;
+        std::vector<TimerEvent> batch;
+        std::unique_lock<std::mutex> lock(mtx_);
+        while (!stop_) {
+            if (active_ == 0) {
+                // Колесо пусто: можно перескочить сразу к текущему тику
+                current_ = std::max(current_, NowTick() + 1);
+                wake_tick_ = UINT64_MAX;
+                cv_.wait(lock, [this]() { return stop_ || active_ > 0; });
+                wake_tick_ = 0;
+                continue;
+            }
+            uint64_t now = NowTick();
+            uint64_t next = NextWorkTickLocked();
+            if (next > now) {
+                wake_tick_ = next;
+                cv_.wait_until(lock, TimeOfTick(next));
+                wake_tick_ = 0;
+                continue;
+            }
+            // Отстали - обрабатываем пропущенные тики подряд, пустые перескакиваем
+            while (next <= now) {
+                current_ = next;
+                AdvanceLocked();
+                next = NextWorkTickLocked();
+            }
+            if (!expired_.empty()) {
+                expired.swap(expired_);
+                lock.unlock();
+                Deliver(expired, batch);
+                lock.lock();
+            }
+        }
+    }
+
+    const std::chrono::nanoseconds tick_;
+    const Clock::time_point start_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    uint64_t current_ = 0;  // следующий необработанный тик
+    uint64_t wake_tick_ = 0;  // до какого тика спит поток колеса; 0 - не спит
+    std::array<Slot, kNearSlots> near_{};
+    std::array<std::array<Slot, kSlots>, kLevels - 1> far_{};
+    std::vector<Node> nodes_;
+    uint32_t free_ = kNil;
+    std::size_t active_ = 0;
+    uint64_t fired_ = 0;
+    uint64_t dropped_ = 0;
+    std::vector<Expired> expired_;
+
+    std::thread thread_;
+};
+
+#endif // TIMER_SERVICE_H_
@@ -8,6 +8,92 @@
 #include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <queue>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Ахо-Корасик сразу по всем именам: один проход по cmdline
+// находит каждое имя, которое входит в нее подстрокой.
+class NameMatcher {
+public:
+    explicit NameMatcher(const std::vector<std::string>& names) {
+        next_.push_back(emptyNode());
+        outputs_.emplace_back();
+        
+        for (size_t id = 0; id < names.size(); ++id) {
+            int node = 0;
+            for (unsigned char c : names[id]) {
+                if (next_[node][c] == 0) {
+                    next_[node][c] = static_cast<int>(next_.size());
+                    next_.push_back(emptyNode());
+                    outputs_.emplace_back();
+                }
+                node = next_[node][c];
+            }
+            outputs_[node].push_back(static_cast<int>(id));
+        }
+        
+        buildTransitions();
+    }
+    
+    // Индексы найденных имен; каждое имя - не больше одного раза
+    std::vector<int> match(const std::string& text) const {
+        std::vector<int> found;
+        int node = 0;
+        
+        for (unsigned char c : text) {
+            node = next_[node][c];
+            found.insert(found.end(), outputs_[node].begin(), outputs_[node].end());
+        }
+        
+        std::sort(found.begin(), found.end());
+        found.erase(std::unique(found.begin(), found.end()), found.end());
+        return found;
+    }
+    
+private:
+    static std::array<int, 256> emptyNode() {
+        std::array<int, 256> node;
+        node.fill(0);
+        return node;
+    }
+    
+    // BFS превращает бор в полный автомат: недостающие переходы идут по
+    // суффиксной ссылке, и узел сообщает также выходы своих суффиксов
+    void buildTransitions() {
+        std::vector<int> fail(next_.size(), 0);
+        std::queue<int> order;
+        
+        for (int c = 0; c < 256; ++c) {
+            if (next_[0][c] != 0) {
+                order.push(next_[0][c]);
+            }
+        }
+        
+        while (!order.empty()) {
+            int node = order.front();
+            order.pop();
+            
+            const std::vector<int>& inherited = outputs_[fail[node]];
+            outputs_[node].insert(outputs_[node].end(), inherited.begin(), inherited.end());
+            
+            for (int c = 0; c < 256; ++c) {
+                int child = next_[node][c];
+                if (child != 0) {
+                    fail[child] = next_[fail[node]][c];
+                    order.push(child);
+                } else {
+                    next_[node][c] = next_[fail[node]][c];
+                }
+            }
+        }
+    }
+    
+    std::vector<std::array<int, 256>> next_;
+    std::vector<std::vector<int>> outputs_;
+};
 
 class Killer {
 public:
@@ -22,7 +108,51 @@ public:
         return true;
     }
     
-    static bool killByName(const std::string& processName) {
+    struct ProcessEntry {
+        pid_t pid;
+        std::string name;
+    };
+    
+    // Та же нормализация, что и раньше: первая строка cmdline, текст после
+    // последнего '/', без NUL-разделителей между аргументами
+    static std::string normalizeCmdline(std::string cmdline) {
+        size_t newline = cmdline.find('\n');
+        if (newline != std::string::npos) {
+            cmdline.resize(newline);
+        }
+        
+        size_t pos = cmdline.find_last_of('/');
+        if (pos != std::string::npos) {
+            cmdline = cmdline.substr(pos + 1);
+        }
+        
+        cmdline.erase(std::remove(cmdline.begin(), cmdline.end(), '\0'), 
+                     cmdline.end());
+        return cmdline;
+    }
+    
+    static bool readCmdline(long pid, std::string& cmdline) {
+        char cmdlinePath[64];
+        snprintf(cmdlinePath, sizeof(cmdlinePath), "/proc/%ld/cmdline", pid);
+        
+        int fd = open(cmdlinePath, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        
+        cmdline.clear();
+        char buffer[4096];
+        ssize_t bytesRead;
+        while ((bytesRead = read(fd, buffer, sizeof(buffer))) > 0) {
+            cmdline.append(buffer, static_cast<size_t>(bytesRead));
+        }
+        close(fd);
+        return bytesRead == 0;
+    }
+    
+    // Один обход /proc: каждый процесс читается один раз при любом числе имен.
+    // У потоков ядра cmdline пуст, их пропускаем, как и раньше
+    static bool snapshotProcesses(std::vector<ProcessEntry>& processes) {
         DIR* dir = opendir("/proc");
         if (!dir) {
             std::cerr << "Failed to open /proc directory. Error: " 
@@ -31,60 +161,87 @@ public:
         }
         
         struct dirent* entry;
-        bool killedAny = false;
+        std::string cmdline;
         
         while ((entry = readdir(dir)) != nullptr) {
             if (entry->d_type == DT_DIR) {
                 char* endptr;
                 long pid = strtol(entry->d_name, &endptr, 10);
                 
-                if (*endptr == '\0') {
-                    char cmdlinePath[256];
-                    snprintf(cmdlinePath, sizeof(cmdlinePath), 
-                            "/proc/%ld/cmdline", pid);
-                    
-                    std::ifstream file(cmdlinePath);
-                    if (file) {
-                        std::string cmdline;
-                        if (std::getline(file, cmdline)) {
-                            size_t pos = cmdline.find_last_of('/');
-                            if (pos != std::string::npos) {
-                                cmdline = cmdline.substr(pos + 1);
-                            }
-                            
-                            cmdline.erase(std::remove(cmdline.begin(), cmdline.end(), '\0'), 
-                                         cmdline.end());
-                            
-                            if (!cmdline.empty() && 
-                                (cmdline == processName || 
-                                 cmdline.find(processName) != std::string::npos)) {
-                                
-                                if (kill(static_cast<pid_t>(pid), SIGTERM) == 0) {
-                                    std::cout << "Process " << cmdline 
-                                              << " (PID: " << pid 
-                                              << ") terminated." << std::endl;
-                                    killedAny = true;
-                                } else {
-                                    std::cerr << "Failed to kill process " << cmdline 
-                                              << " (PID: " << pid 
-                                              << "). Error: " << strerror(errno) << std::endl;
-                                }
-                            }
-                        }
+                if (*endptr == '\0' && readCmdline(pid, cmdline)) {
+                    std::string name = normalizeCmdline(cmdline);
+                    if (!name.empty()) {
+                        processes.push_back({static_cast<pid_t>(pid), std::move(name)});
                     }
                 }
             }
         }
         
         closedir(dir);
+        return true;
+    }
+    
+    static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+    
+    // Процесс подходит, если имя входит в его нормализованный cmdline.
+    // Процесс, подходящий под несколько имен, получает один SIGTERM
+    static bool killByNames(const std::vector<std::string>& processNames) {
+        auto scanStart = std::chrono::steady_clock::now();
+        std::vector<ProcessEntry> processes;
+        if (!snapshotProcesses(processes)) {
+            return false;
+        }
+        double scanMs = millisecondsSince(scanStart);
         
-        if (!killedAny) {
-            std::cout << "No processes found with name: " << processName << std::endl;
+        auto matchStart = std::chrono::steady_clock::now();
+        NameMatcher matcher(processNames);
+        std::vector<std::pair<const ProcessEntry*, std::vector<int>>> victims;
+        for (const auto& process : processes) {
+            std::vector<int> found = matcher.match(process.name);
+            if (!found.empty()) {
+                victims.emplace_back(&process, std::move(found));
+            }
+        }
+        double matchMs = millisecondsSince(matchStart);
+        
+        std::cout << "Scanned " << processes.size() << " processes in " 
+                  << scanMs << " ms, matched " << processNames.size() 
+                  << " names in " << matchMs << " ms." << std::endl;
+        
+        bool killedAny = false;
+        std::vector<bool> nameKilled(processNames.size(), false);
+        for (const auto& [process, found] : victims) {
+            if (kill(process->pid, SIGTERM) == 0) {
+                std::cout << "Process " << process->name 
+                          << " (PID: " << process->pid 
+                          << ") terminated." << std::endl;
+                killedAny = true;
+                for (int id : found) {
+                    nameKilled[id] = true;
+                }
+            } else {
+                std::cerr << "Failed to kill process " << process->name 
+                          << " (PID: " << process->pid 
+                          << "). Error: " << strerror(errno) << std::endl;
+            }
+        }
+        
+        for (size_t i = 0; i < processNames.size(); ++i) {
+            if (!nameKilled[i]) {
+                std::cout << "No processes found with name: " << processNames[i] << std::endl;
+            }
         }
         
         return killedAny;
     }
     
+    static bool killByName(const std::string& processName) {
+        return killByNames({processName});
+    }
+    
     static std::vector<std::string> getProcessesFromEnv() {
         std::vector<std::string> processes;
         
@@ -109,6 +266,13 @@ public:
         return processes;
     }
     
+    static void showUsage() {
+        std::cout << "Usage:" << std::endl;
+        std::cout << "  ./Killer --id <pid>" << std::endl;
+        std::cout << "  ./Killer --name <process_name>" << std::endl;
+        std::cout << "  PROC_TO_KILL=\"firefox,chrome\" ./Killer" << std::endl;
+    }
+
     static void killFromEnvironment() {
         std::cout << "Reading environment variable PROC_TO_KILL..." << std::endl;
         
@@ -134,9 +298,7 @@ public:
         }
         std::cout << std::endl;
         
-        for (const auto& procName : processes) {
-            killByName(procName);
-        }
+        killByNames(processes);
     }
 };
 
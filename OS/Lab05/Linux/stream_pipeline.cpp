@@ -0,0 +1,93 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <optional>
+
+#include "../../Lab03/stream.h"
+
+const int N = 26;
+
+// Та же цепочка M(*7) -> A(+N) -> P(*3) -> S(сумма), что и в main.cpp,
+// но внутри одного процесса: стадии - потоки, pipe заменены каналами.
+// Без аргументов читает числа из строки, как main.cpp;
+// с аргументом count прогоняет count чисел 1..count и печатает статистику стадий.
+// Обе цепочки считают в long long с первой стадии, чтобы *7 и *3 не переполнялись.
+int main(int argc, char* argv[]) {
+    std::vector<int> numbers;
+    bool generated = argc > 1;
+
+    if (generated) {
+        int count = std::atoi(argv[1]);
+        for (int i = 1; i <= count; i++) numbers.push_back(i);
+    } else {
+        std::cout << "ENTER THE NUMBERS SEPARATED BY A SPACE: ";
+        std::string inputStr;
+        std::getline(std::cin, inputStr);
+        std::istringstream iss(inputStr);
+        int num;
+        while (iss >> num) numbers.push_back(num);
+    }
+
+    long long sum = 0;
+    std::size_t next = 0;
+    Pipeline pipeline(256);
+
+    pipeline.Source<int>("input", [&]() -> std::optional<int> {
+                if (next == numbers.size()) return std::nullopt;
+                return numbers[next++];
+            })
+        .Map("M (*7)", [](int num) { return static_cast<long long>(num) * 7; }, 2)
+        .Map("A (+26)", [](long long num) { return num + N; }, 2, MapOrder::kUnordered)
+        .Map("P (*3)", [](long long num) { return num * 3; })
+        .Sink("S (sum)", [&](long long num) { sum += num; });
+
+    pipeline.Wait();
+
+    std::cout << "Result: " << sum << std::endl;
+
+    // Та же сумма другим путем, через остальные стадии: нули сумму не меняют
+    // и отсеиваются, остальное идет порциями, суммы порций складываются
+    // отдельно по четности и затем вместе
+    long long checked = 0;
+    next = 0;
+    Pipeline check(256);
+
+    check.Source<int>("input", [&]() -> std::optional<int> {
+                if (next == numbers.size()) return std::nullopt;
+                return numbers[next++];
+            })
+        .Map("M-A-P", [](int num) { return (static_cast<long long>(num) * 7 + N) * 3; }, 2)
+        .Filter("non-zero", [](long long num) { return num != 0; })
+        .Batch("batch 64", 64)
+        .Map("batch sum", [](std::vector<long long> batch) {
+                long long total = 0;
+                for (long long num : batch) total += num;
+                return total;
+            })
+        .ReduceByKey("by parity", [](long long total) { return total % 2 != 0; }, 0LL,
+                     [](long long acc, long long total) { return acc + total; })
+        .Sink("S (sum)", [&](std::pair<bool, long long> parity) { checked += parity.second; });
+
+    check.Wait();
+
+    if (checked != sum) {
+        std::cerr << "Check failed: " << checked << " != " << sum << std::endl;
+        return 1;
+    }
+
+    if (generated) {
+        std::cout << "\nStage statistics:\n";
+        for (const auto& stage : pipeline.Stats()) {
+            std::cout << "  " << stage << std::endl;
+        }
+        std::cout << "\nCheck pipeline (filter, batch, reduce by key):\n";
+        for (const auto& stage : check.Stats()) {
+            std::cout << "  " << stage << std::endl;
+        }
+    }
+
+    return 0;
+}